@@ -2,14 +2,35 @@
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aTransform; // xy position, zw scale
+layout (location = 3) in vec4 aAnimation; // x start time, y frame duration, z frame count, w first frame
+layout (location = 4) in vec4 aPlayback;  // x frame step, y 1 when looping, z 1 when flipped, w first frame of the sheet in u_frames
 
-uniform mat4 u_model;
 uniform mat4 u_projection;
+uniform float u_time;
+
+// atlas rect of every sheet frame, xy corner and zw size in texture coordinates
+uniform vec4 u_frames[64];
 
 out vec2 TexCoord;
 
 void main() {
-   gl_Position = u_projection * u_model * vec4(aPos.x, aPos.y, aPos.z, 1.0);
-   // gl_Position = vec4(aPos, 1.0);
-   TexCoord = aTexCoord;
+   vec2 position = aTransform.xy + aPos.xy * aTransform.zw;
+   gl_Position = u_projection * vec4(position, aPos.z, 1.0);
+
+   // frames played since the state started, looping wraps and the rest hold on their last frame
+   float frameCount = aAnimation.z;
+   float played = max(floor((u_time - aAnimation.x) / aAnimation.y), 0.0);
+   float frame = aAnimation.w + aPlayback.x * played;
+   if (aPlayback.y > 0.5) {
+      frame = mod(frame, frameCount);
+   }
+   else {
+      frame = clamp(frame, 0.0, frameCount - 1.0);
+   }
+
+   // map the quad onto the frame's rect in the atlas, mirrored when flipped
+   vec4 rect = u_frames[int(aPlayback.w) + int(frame)];
+   float u = mix(aTexCoord.x, 1.0 - aTexCoord.x, aPlayback.z);
+   TexCoord = rect.xy + vec2(u, aTexCoord.y) * rect.zw;
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// egl
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// std
+#include <iostream>
+
+// surfaceless EGL context rendering into an offscreen framebuffer, works with Mesa's software rasterizer
+class HeadlessContext {
+public:
+	HeadlessContext(int width, int height) : width(width), height(height) {
+		display = EGL_NO_DISPLAY;
+		auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay) {
+			display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+		if (display == EGL_NO_DISPLAY) {
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+
+		EGLint major, minor;
+		if (!eglInitialize(display, &major, &minor)) {
+			std::cout << "Failed to initialize EGL" << std::endl;
+			return;
+		}
+		eglBindAPI(EGL_OPENGL_API);
+
+		const EGLint configAttributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+		EGLConfig config;
+		EGLint configCount = 0;
+		eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+		// using openGL version 3.3 like the app
+		const EGLint contextAttributes[] = {
+			EGL_CONTEXT_MAJOR_VERSION, 3,
+			EGL_CONTEXT_MINOR_VERSION, 3,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, configCount ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+		if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+			std::cout << "Failed to create EGL context" << std::endl;
+			return;
+		}
+
+		if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+			std::cout << "Failed to initialize GLAD" << std::endl;
+			return;
+		}
+
+		glGenRenderbuffers(1, &colorID);
+		glBindRenderbuffer(GL_RENDERBUFFER, colorID);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glGenFramebuffers(1, &framebufferID);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorID);
+		glViewport(0, 0, width, height);
+		valid = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	}
+	~HeadlessContext() {
+		if (valid) {
+			glDeleteFramebuffers(1, &framebufferID);
+			glDeleteRenderbuffers(1, &colorID);
+		}
+		if (context != EGL_NO_CONTEXT) {
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext(display, context);
+		}
+		if (display != EGL_NO_DISPLAY) {
+			eglTerminate(display);
+		}
+	}
+
+	// a context is current on one thread at a time, release it before another thread makes it current
+	void makeCurrent() { eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context); }
+	void release() { eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT); }
+
+	bool isValid() const { return valid; }
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	// stands in for the window's default framebuffer
+	GLuint getFramebufferID() const { return framebufferID; }
+
+private:
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLContext context = EGL_NO_CONTEXT;
+	GLuint framebufferID = 0, colorID = 0;
+	int width, height;
+	bool valid = false;
+};
@@ -0,0 +1,75 @@
+// fast-forwards a day with World::advance and compares it with stepping every tick of the same day,
+// fails unless every pet ends in the same state, entered on the same tick, at the same position to the bit
+
+// core
+#include "core/World.h"
+
+// std
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+void spawn(World& world, size_t pets) {
+	for (size_t i = 0; i < pets; ++i) {
+		world.spawn(glm::vec2(world.randomFloat(-5.0f, 5.0f), 0.0f), glm::vec2(0.5f, 0.5f));
+	}
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// advance_bench [hours] [pets to also step tick by tick, up to]
+int main(int argc, char* argv[]) {
+	double hours = argc > 1 ? std::atof(argv[1]) : 24.0;
+	size_t maxStepped = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+	double seconds = hours * 3600.0;
+
+	std::cout << hours << " h fast-forward" << std::endl;
+	size_t diverged = 0;
+	for (size_t pets : {1, 10, 100, 1000}) {
+		WorldSettings settings;
+		settings.seed = 1;
+		World advanced(settings);
+		spawn(advanced, pets);
+
+		auto start = std::chrono::steady_clock::now();
+		size_t transitions = advanced.advance(seconds);
+		double advanceSeconds = secondsSince(start);
+
+		std::cout << pets << " pets: " << transitions << " transitions in " << advanceSeconds * 1e3 << " ms";
+
+		// the reference steps every tick with the catch-up budget lifted, only for small populations
+		if (pets <= maxStepped) {
+			settings.maxStepsPerUpdate = ~0u;
+			World stepped(settings);
+			spawn(stepped, pets);
+
+			start = std::chrono::steady_clock::now();
+			stepped.step(seconds);
+			double stepSeconds = secondsSince(start);
+
+			// legs repeat the kernels' float math, so nothing may differ at all
+			size_t same = 0;
+			uint64_t maxTickShift = 0;
+			for (size_t i = 0; i < pets; ++i) {
+				const Population& a = advanced.getPopulation();
+				const Population& b = stepped.getPopulation();
+				same += a.state[i] == b.state[i] && a.stateStartTick[i] == b.stateStartTick[i] && a.positionX[i] == b.positionX[i] && a.positionY[i] == b.positionY[i];
+				uint64_t shift = a.stateStartTick[i] > b.stateStartTick[i] ? a.stateStartTick[i] - b.stateStartTick[i] : b.stateStartTick[i] - a.stateStartTick[i];
+				maxTickShift = std::max(maxTickShift, shift);
+			}
+			std::cout << ", stepping " << advanced.getTickCount() << " ticks took " << stepSeconds * 1e3 << " ms ("
+				<< stepSeconds / advanceSeconds << "x), " << same << "/" << pets << " pets the same, "
+				<< "state starts at most " << maxTickShift << " ticks apart";
+			diverged += pets - same;
+		}
+		std::cout << std::endl;
+	}
+	if (diverged > 0) {
+		std::cout << "error advancing | " << diverged << " pets | Ended elsewhere than stepping every tick." << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,154 @@
+// counts the heap allocations of each part of a frame the way the app runs it: stepping, publishing
+// a snapshot, collecting damage and drawing, under a headless software context
+// after warm-up a frame should not allocate at all, --abort stops on the first allocation that does
+
+// core
+#include "core/Allocations.h"
+#include "core/FrameArena.h"
+#include "core/JobSystem.h"
+#include "core/Scheduler.h"
+#include "core/Snapshot.h"
+#include "core/TripleBuffer.h"
+#include "core/World.h"
+
+// render
+#include "render/Canvas.h"
+#include "render/DamageTracker.h"
+#include "render/ResourceRegistry.h"
+#include "render/SpriteRenderer.h"
+
+// bench
+#include "bench/HeadlessContext.h"
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// allocations per part over the frames they were counted for
+struct FrameAllocations {
+	uint64_t step = 0, wait = 0, capture = 0, damage = 0, draw = 0;
+	uint64_t frames = 0;
+
+	uint64_t getTotal() const { return step + wait + capture + damage + draw; }
+};
+
+// runs part and adds what it allocated on this thread to count, inside a NoAllocationScope when checking
+template<typename Part>
+void count(uint64_t& allocations, bool checking, bool abortOnAllocation, Part&& part) {
+	uint64_t before = Allocations::getThreadCounts().allocations;
+	if (checking) {
+		NoAllocationScope scope(abortOnAllocation);
+		part();
+	}
+	else {
+		part();
+	}
+	allocations += Allocations::getThreadCounts().allocations - before;
+}
+
+void print(const char* name, const FrameAllocations& counted) {
+	double frames = (double)counted.frames;
+	std::cout << name << counted.getTotal() / frames << " per frame (step " << counted.step / frames << ", wait " << counted.wait / frames
+		<< ", snapshot " << counted.capture / frames << ", damage " << counted.damage / frames << ", draw " << counted.draw / frames << ")" << std::endl;
+}
+
+// alloc_bench [pets] [seconds] [threads] [--abort]
+int main(int argc, char* argv[]) {
+	size_t pets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+	double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+	unsigned threads = argc > 3 ? (unsigned)std::atoi(argv[3]) : 2;
+	bool abortOnAllocation = argc > 4 && std::strcmp(argv[4], "--abort") == 0;
+
+	if (!Allocations::isTracking()) {
+		std::cout << "error counting | operator new | The allocation hook isn't linked in." << std::endl;
+		return 1;
+	}
+
+	HeadlessContext context(1920, 1080 / 13);
+	if (!context.isValid()) {
+		return 1;
+	}
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	float aspectRatio = (float)context.getWidth() / (float)context.getHeight();
+	float orthoWidth = 10.0f;
+	float orthoHeight = orthoWidth / aspectRatio;
+	glm::mat4 projection = glm::ortho(-orthoWidth / 2, orthoWidth / 2, -orthoHeight / 2, orthoHeight / 2, -1.0f, 1.0f);
+
+	ResourceRegistry resources(CAPYBARA_RESOURCE_DIR);
+	SpriteRenderer renderer(resources);
+	Canvas canvas;
+	canvas.resize(context.getWidth(), context.getHeight());
+	DamageTracker damage;
+
+	// what the app runs by default
+	WorldSettings settings;
+	settings.seed = 1;
+	settings.timestep = 1.0 / 20.0;
+	settings.social.enabled = true;
+	settings.capacity = (uint32_t)pets;
+	World world(settings);
+	JobSystem jobs(threads);
+	if (jobs.getThreadCount() > 1) {
+		world.setJobSystem(&jobs);
+	}
+	for (size_t i = 0; i < pets; ++i) {
+		world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+	}
+	FrameScheduler scheduler;
+	TripleBuffer<WorldSnapshot> snapshots;
+
+	// a frame's scratch, one arena per thread in the app, reset at the top of its loop
+	FrameArena simArena(world.getScratchBytes());
+	FrameArena renderArena(DamageTracker::getScratchBytes(pets));
+	world.setFrameArena(&simArena);
+	damage.setFrameArena(&renderArena);
+
+	std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+	std::cout << pets << " pets, " << jobs.getThreadCount() << " threads, " << seconds << " s at 60 Hz after as long to warm up" << std::endl;
+
+	// the first half warms up, every container reaching the size it keeps, the second half is checked
+	constexpr uint64_t frameNanoseconds = 1000000000ull / 60;
+	uint64_t frames = (uint64_t)(seconds * 60.0);
+	FrameAllocations warmUp, steady;
+	for (uint64_t i = 0; i < 2 * frames; ++i) {
+		bool checking = i >= frames;
+		FrameAllocations& counted = checking ? steady : warmUp;
+		++counted.frames;
+		simArena.reset();
+		renderArena.reset();
+
+		count(counted.step, checking, abortOnAllocation, [&]() { world.stepNanoseconds(frameNanoseconds); });
+		count(counted.wait, checking, abortOnAllocation, [&]() { scheduler.getWaitTime(world); });
+		count(counted.capture, checking, abortOnAllocation, [&]() {
+			snapshots.getBack().capture(world);
+			snapshots.publish();
+			snapshots.take();
+		});
+		RenderView view(snapshots.getFront());
+		bool changed = false;
+		count(counted.damage, checking, abortOnAllocation, [&]() { changed = damage.update(view, projection, canvas.getWidth(), canvas.getHeight()); });
+		count(counted.draw, checking, abortOnAllocation, [&]() {
+			if (changed) {
+				canvas.bind();
+				renderer.draw(view, projection, damage.getRects());
+				canvas.present(context.getFramebufferID());
+			}
+		});
+	}
+	glFinish();
+
+	print("warm-up: ", warmUp);
+	print("steady:  ", steady);
+	std::cout << "arenas:  simulation " << simArena.getHighWater() / 1024.0 << " of " << simArena.getCapacity() / 1024.0 << " KiB, render "
+		<< renderArena.getHighWater() / 1024.0 << " of " << renderArena.getCapacity() / 1024.0 << " KiB at most, "
+		<< simArena.getOverflowCount() + renderArena.getOverflowCount() << " allocations overflowed" << std::endl;
+	std::cout << Allocations::getViolations() << " allocations after warm-up" << std::endl;
+	return Allocations::getViolations() == 0 ? 0 : 1;
+}
@@ -0,0 +1,272 @@
+// compares the hand written state switch World used to decide with the compiled behavior tables,
+// and the tables' alias method sampling with the cumulative weight scan it replaced
+
+// core
+#include "core/Behavior.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// everything a state change draws, the next state, a new target and how long or fast the state goes
+struct Decision {
+	uint8_t state;
+	float target;
+	float durationOrSpeed;
+};
+
+// World::timerExpired, arrived and enterState before the tables
+Decision decideSwitch(AnimationStates state, RandomStream& random) {
+	Decision decision = {0, 0.0f, 0.0f};
+	switch (state) {
+		case AnimationStates::Idle: {
+			float nextState = random.nextFloat();
+			decision.target = random.nextFloat(-5.0f, 5.0f);
+			if (nextState < 0.2f) {
+				decision.state = AnimationStates::Idle;
+			}
+			else if (nextState < 0.6f) {
+				decision.state = AnimationStates::Walk;
+			}
+			else if (nextState < 0.8f) {
+				decision.state = AnimationStates::Run;
+			}
+			else {
+				decision.state = AnimationStates::Sit;
+			}
+			break;
+		}
+		case AnimationStates::Sit:
+			decision.state = AnimationStates::GetUp;
+			break;
+		case AnimationStates::GetUp:
+			decision.state = AnimationStates::Idle;
+			break;
+		case AnimationStates::Walk: {
+			float nextState = random.nextFloat();
+			if (nextState < 0.5f) {
+				decision.state = AnimationStates::Idle;
+			}
+			else if (nextState < 0.7f) {
+				decision.target = random.nextFloat(-5.0f, 5.0f);
+				decision.state = AnimationStates::Run;
+			}
+			else {
+				decision.state = AnimationStates::Sit;
+			}
+			break;
+		}
+		case AnimationStates::Run:
+			decision.target = random.nextFloat(-5.0f, 5.0f);
+			decision.state = AnimationStates::Walk;
+			break;
+	}
+
+	switch (decision.state) {
+		case AnimationStates::Walk:  decision.durationOrSpeed = 0.5f; break;
+		case AnimationStates::Run:   decision.durationOrSpeed = 1.0f; break;
+		case AnimationStates::Idle:  decision.durationOrSpeed = random.nextFloat(3.0f, 6.0f); break;
+		case AnimationStates::Sit:   decision.durationOrSpeed = 3.0f; break;
+		case AnimationStates::GetUp: decision.durationOrSpeed = 0.5f; break;
+	}
+	return decision;
+}
+
+// World::follow and enterState, after the tables picked the transition
+Decision follow(const Behavior& behavior, uint32_t picked, RandomStream& random) {
+	Decision decision = {0, 0.0f, 0.0f};
+	const Transition& transition = behavior.transitions[picked];
+	decision.state = transition.nextState;
+	if (transition.newTarget) {
+		decision.target = random.nextFloat(-5.0f, 5.0f);
+	}
+	AnimationStates next = (AnimationStates)transition.nextState;
+	decision.durationOrSpeed = behavior.isMoving(next) ? behavior.states[next].speed : behavior.drawDuration(next, random);
+	return decision;
+}
+
+struct RunResult {
+	double seconds = 0.0;
+	uint64_t stateCounts[numberOfAnimationStates] = {};
+};
+
+// every pet takes rounds decisions in a row, starting from Idle, decide sees all pets of a round at once
+template<typename Decide>
+RunResult run(size_t pets, int rounds, Decide&& decide) {
+	std::vector<RandomStream> streams(pets);
+	std::vector<uint8_t> states(pets, AnimationStates::Idle);
+	std::vector<Decision> decisions(pets);
+	for (size_t i = 0; i < pets; ++i) {
+		streams[i] = RandomStream(1, i);
+	}
+
+	RunResult result;
+	auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < rounds; ++round) {
+		decide(states, streams, decisions);
+		for (size_t i = 0; i < pets; ++i) {
+			states[i] = decisions[i].state;
+			++result.stateCounts[decisions[i].state];
+		}
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+// the largest difference in how often a state was entered, in percentage points
+double compareCounts(const RunResult& a, const RunResult& b, double decisions) {
+	double difference = 0.0;
+	for (int i = 0; i < numberOfAnimationStates; ++i) {
+		difference = std::max(difference, std::abs((double)a.stateCounts[i] - (double)b.stateCounts[i]) / decisions * 100.0);
+	}
+	return difference;
+}
+
+bool sameTables(const Behavior& a, const Behavior& b) {
+	for (int i = 0; i < numberOfAnimationStates; ++i) {
+		const StateBehavior& x = a.states[i];
+		const StateBehavior& y = b.states[i];
+		if (x.speed != y.speed || x.minDuration != y.minDuration || x.maxDuration != y.maxDuration ||
+			x.firstTransition != y.firstTransition || x.transitionCount != y.transitionCount) {
+			return false;
+		}
+	}
+	for (size_t i = 0; i < maxBehaviorTransitions; ++i) {
+		const Transition& x = a.transitions[i];
+		const Transition& y = b.transitions[i];
+		if (x.aliasThreshold != y.aliasThreshold || x.alias != y.alias || x.nextState != y.nextState || x.newTarget != y.newTarget) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// what the tables did before the alias method, a scan over cumulative weights
+struct CumulativeTable {
+	std::vector<float> cumulative;
+
+	explicit CumulativeTable(const std::vector<double>& weights) {
+		double total = 0.0, sum = 0.0;
+		for (double weight : weights) {
+			total += weight;
+		}
+		for (double weight : weights) {
+			sum += weight;
+			cumulative.push_back((float)(sum / total));
+		}
+		cumulative.back() = 1.0f;
+	}
+
+	uint32_t sample(RandomStream& random) const {
+		float draw = random.nextFloat();
+		uint32_t picked = 0;
+		for (size_t i = 0; i + 1 < cumulative.size(); ++i) {
+			picked += draw >= cumulative[i];
+		}
+		return picked;
+	}
+};
+
+// samples one state with n weighted transitions both ways, reports time per sample and the worst
+// difference between how often a transition came up and its weight
+void compareSamplers(size_t n, size_t samples) {
+	std::vector<double> weights;
+	std::vector<StateDescription> descriptions = {waits(Walk, 1.0f), waits(Run, 1.0f), waits(Idle, 1.0f), waits(Sit, 1.0f), waits(GetUp, 1.0f)};
+	std::vector<TransitionDescription> transitions;
+	double total = 0.0;
+	for (size_t i = 0; i < n; ++i) {
+		weights.push_back((double)(i % 7 + 1));
+		total += weights.back();
+		transitions.push_back({Idle, (AnimationStates)(i % numberOfAnimationStates), weights.back(), false});
+	}
+	for (AnimationStates state : {Walk, Run, Sit, GetUp}) {
+		transitions.push_back({state, Idle, 1.0, false});
+	}
+	Behavior behavior;
+	compileBehavior(descriptions.data(), descriptions.size(), transitions.data(), transitions.size(), behavior);
+	CumulativeTable table(weights);
+	uint32_t first = behavior.states[Idle].firstTransition;
+
+	std::vector<uint64_t> scanCounts(n), aliasCounts(n);
+	RandomStream random(1, 0);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < samples; ++i) {
+		++scanCounts[table.sample(random)];
+	}
+	double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	random = RandomStream(1, 0);
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < samples; ++i) {
+		++aliasCounts[behavior.decide(Idle, random) - first];
+	}
+	double aliasSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	double scanError = 0.0, aliasError = 0.0;
+	for (size_t i = 0; i < n; ++i) {
+		scanError = std::max(scanError, std::abs((double)scanCounts[i] / samples - weights[i] / total) * 100.0);
+		aliasError = std::max(aliasError, std::abs((double)aliasCounts[i] / samples - weights[i] / total) * 100.0);
+	}
+	std::cout << "  " << n << " transitions: cumulative scan " << scanSeconds / samples * 1e9 << " ns, alias "
+		<< aliasSeconds / samples * 1e9 << " ns (" << scanSeconds / aliasSeconds << "x), off by at most "
+		<< scanError << " / " << aliasError << " percentage points" << std::endl;
+}
+
+// behavior_bench [pets] [rounds]
+int main(int argc, char* argv[]) {
+	size_t pets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	int rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+
+	// the shipped description has to compile to the built in tables
+	Behavior loaded;
+	std::string path = std::string(CAPYBARA_RESOURCE_DIR) + "/res/behaviors/capybara.behavior";
+	bool loadedSame = loaded.load(path) && sameTables(loaded, capybaraBehavior);
+	std::cout << path << (loadedSame ? " matches" : " DIFFERS FROM") << " the built in tables" << std::endl;
+
+	std::cout << "weighted choice, 10M samples of one state" << std::endl;
+	for (size_t n : {2, 4, 8, 16, 24}) {
+		compareSamplers(n, 10000000);
+	}
+
+	RunResult switched = run(pets, rounds, [](std::vector<uint8_t>& states, std::vector<RandomStream>& streams, std::vector<Decision>& decisions) {
+		for (size_t i = 0; i < states.size(); ++i) {
+			decisions[i] = decideSwitch((AnimationStates)states[i], streams[i]);
+		}
+	});
+	RunResult single = run(pets, rounds, [&](std::vector<uint8_t>& states, std::vector<RandomStream>& streams, std::vector<Decision>& decisions) {
+		for (size_t i = 0; i < states.size(); ++i) {
+			decisions[i] = follow(loaded, loaded.decide((AnimationStates)states[i], streams[i]), streams[i]);
+		}
+	});
+	std::vector<uint32_t> everyone(pets), picked(pets);
+	for (size_t i = 0; i < pets; ++i) {
+		everyone[i] = (uint32_t)i;
+	}
+	RunResult batched = run(pets, rounds, [&](std::vector<uint8_t>& states, std::vector<RandomStream>& streams, std::vector<Decision>& decisions) {
+		loaded.sample(everyone.data(), pets, states.data(), streams.data(), picked.data());
+		for (size_t i = 0; i < states.size(); ++i) {
+			decisions[i] = follow(loaded, picked[i], streams[i]);
+		}
+	});
+
+	// the alias tables map draws to transitions differently, so only the odds have to agree
+	double decisions = (double)pets * rounds;
+	double difference = std::max(compareCounts(switched, single, decisions), compareCounts(switched, batched, decisions));
+	std::cout << pets << " pets, " << rounds << " whole decisions each" << std::endl;
+	std::cout << "  switch:       " << switched.seconds / decisions * 1e9 << " ns/decision" << std::endl;
+	std::cout << "  table:        " << single.seconds / decisions * 1e9 << " ns/decision (" << switched.seconds / single.seconds << "x)" << std::endl;
+	std::cout << "  table sample: " << batched.seconds / decisions * 1e9 << " ns/decision (" << switched.seconds / batched.seconds << "x)" << std::endl;
+	std::cout << "  states entered:";
+	const char* names[numberOfAnimationStates] = {"Walk", "Run", "Idle", "Sit", "GetUp"};
+	for (int i = 0; i < numberOfAnimationStates; ++i) {
+		std::cout << " " << names[i] << " " << switched.stateCounts[i] / decisions * 100.0 << "%";
+	}
+	std::cout << ", the tables differ by at most " << difference << " percentage points" << std::endl;
+	return loadedSame && difference < 0.1 ? 0 : 1;
+}
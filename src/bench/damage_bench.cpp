@@ -0,0 +1,220 @@
+// compares redrawing the whole window every vsync with damage tracked redraws, under a headless software context
+// every frame the damage tracked canvas is also checked against a full redraw, pixel for pixel
+
+// core
+#include "core/Snapshot.h"
+#include "core/World.h"
+
+// render
+#include "render/Canvas.h"
+#include "render/DamageTracker.h"
+#include "render/SpriteRenderer.h"
+
+// bench
+#include "bench/HeadlessContext.h"
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+struct RunResult {
+	int presents = 0;
+	double filledPixels = 0.0; // cleared and redrawn, summed over frames
+	double copiedPixels = 0.0; // copied from the canvas into the window, summed over frames
+	double seconds = 0.0;      // CPU time including waiting for the GPU
+	int mismatchedFrames = 0;
+	int drawCalls = 0; // instanced passes over the population
+	int fullRedraws = 0;  // presents the tracker redrew whole, the first one or past the cost of the rects
+	int overFullCost = 0; // presents whose rects were estimated to cost more than a full redraw, or took more passes
+};
+
+std::vector<unsigned char> readPixels(GLuint framebuffer, int width, int height) {
+	std::vector<unsigned char> pixels((size_t)width * height * 4);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+// pets wander range wide around the window's centre, the window shows 10
+WorldSettings getSettings(double simRate, float range) {
+	WorldSettings settings;
+	settings.timestep = 1.0 / simRate;
+	settings.minX = -range / 2;
+	settings.maxX = range / 2;
+	return settings;
+}
+
+void spawn(World& world, size_t pets) {
+	const WorldSettings& settings = world.getSettings();
+	for (size_t i = 0; i < pets; ++i) {
+		world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+	}
+}
+
+// every half second a random pet leaves and a new one arrives, the last pet takes over the leaver's index
+void churn(World& world, int frame, bool enabled) {
+	if (!enabled || frame % 30 != 29) {
+		return;
+	}
+	size_t index = std::min((size_t)world.randomFloat(0.0f, (float)world.size()), world.size() - 1);
+	world.despawn(world.getHandle(index));
+	spawn(world, 1);
+}
+
+// the old loop, clear and draw everything into the window and present at every vsync
+RunResult runFull(HeadlessContext& context, ResourceRegistry& resources, const glm::mat4& projection, size_t pets, int frames, double simRate, float range, bool churning) {
+	SpriteRenderer renderer(resources);
+	World world(getSettings(simRate, range));
+	spawn(world, pets);
+	WorldSnapshot snapshot;
+	Canvas canvas;
+	canvas.resize(context.getWidth(), context.getHeight());
+
+	RunResult result;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; ++i) {
+		churn(world, i, churning);
+		world.step(1.0 / 60.0);
+		snapshot.capture(world);
+		canvas.bind();
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		result.drawCalls += renderer.draw(snapshot, projection).drawCalls;
+		canvas.present(context.getFramebufferID());
+		glFinish();
+		++result.presents;
+		result.filledPixels += (double)context.getWidth() * context.getHeight();
+		result.copiedPixels += (double)context.getWidth() * context.getHeight();
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	canvas.destroy();
+	return result;
+}
+
+RunResult runDamage(HeadlessContext& context, ResourceRegistry& resources, const glm::mat4& projection, size_t pets, int frames, double simRate, float range, bool churning, bool verify) {
+	// the reference keeps its own instance buffer so checking doesn't change what the tracked path uploads
+	SpriteRenderer renderer(resources);
+	SpriteRenderer referenceRenderer(resources);
+	World world(getSettings(simRate, range));
+	spawn(world, pets);
+	WorldSnapshot snapshot;
+	Canvas canvas, reference;
+	canvas.resize(context.getWidth(), context.getHeight());
+	reference.resize(context.getWidth(), context.getHeight());
+	DamageTracker damage;
+
+	RunResult result;
+	double verifySeconds = 0.0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; ++i) {
+		churn(world, i, churning);
+		world.step(1.0 / 60.0);
+		snapshot.capture(world);
+		if (damage.update(snapshot, projection, canvas.getWidth(), canvas.getHeight())) {
+			canvas.bind();
+			int drawCalls = renderer.draw(snapshot, projection, damage.getRects()).drawCalls;
+			result.drawCalls += drawCalls;
+			// the headless framebuffer keeps its pixels, like a back buffer whose age is always 1
+			DamageRect copied = canvas.present(damage.getRects(), 1, context.getFramebufferID());
+			glFinish();
+			++result.presents;
+			result.filledPixels += damage.getDamagedArea();
+			result.copiedPixels += copied.getArea();
+			result.fullRedraws += damage.isFullFrame();
+			// a frame falling back to a full redraw has to come down to a single pass
+			result.overFullCost += damage.getRedrawCost() > damage.getFullRedrawCost() || (damage.isFullFrame() && drawCalls > 1);
+		}
+
+		if (verify) {
+			auto verifyStart = std::chrono::steady_clock::now();
+			reference.bind();
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			referenceRenderer.draw(snapshot, projection);
+			// what the window shows has to match too, the canvas only copied what changed into it
+			std::vector<unsigned char> expected = readPixels(reference.getFramebufferID(), reference.getWidth(), reference.getHeight());
+			if (readPixels(canvas.getFramebufferID(), canvas.getWidth(), canvas.getHeight()) != expected
+				|| readPixels(context.getFramebufferID(), context.getWidth(), context.getHeight()) != expected) {
+				++result.mismatchedFrames;
+			}
+			verifySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - verifyStart).count();
+		}
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - verifySeconds;
+	canvas.destroy();
+	reference.destroy();
+	return result;
+}
+
+void print(const char* name, const RunResult& result, int frames, int width, int height) {
+	std::cout << "  " << name << result.presents << "/" << frames << " frames presented, "
+		<< result.filledPixels / ((double)frames * width * height) * 100.0 << "% of pixels filled, "
+		<< result.copiedPixels / ((double)frames * width * height) * 100.0 << "% copied to the window, "
+		<< result.seconds / frames * 1e3 << " ms per vsync, "
+		<< (double)result.drawCalls / std::max(result.presents, 1) << " draws per frame" << std::endl;
+}
+
+// damage_bench [seconds] [--no-verify]
+int main(int argc, char* argv[]) {
+	double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+	bool verify = !(argc > 2 && std::strcmp(argv[2], "--no-verify") == 0);
+	int frames = (int)(seconds * 60.0);
+
+	// same shape as the app's window on a 1080p display
+	HeadlessContext context(1920, 1080 / 13);
+	if (!context.isValid()) {
+		return 1;
+	}
+
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	float aspectRatio = (float)context.getWidth() / (float)context.getHeight();
+	float orthoWidth = 10.0f;
+	float orthoHeight = orthoWidth / aspectRatio;
+	glm::mat4 projection = glm::ortho(-orthoWidth / 2, orthoWidth / 2, -orthoHeight / 2, orthoHeight / 2, -1.0f, 1.0f);
+
+	ResourceRegistry resources(CAPYBARA_RESOURCE_DIR);
+	std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+	std::cout << seconds << " s at 60 Hz" << std::endl;
+	// nothing here swaps, a window still hands the whole back buffer to the compositor on every present
+	// unless the platform takes swap damage, and without a buffer age the whole canvas is copied into it
+	std::cout << "copies assume the window keeps its last frame (buffer age 1), swaps and compositing aren't measured" << std::endl;
+
+	// the 20 Hz runs step the world slower than the display, so frames between ticks are blended,
+	// the one after spawns and despawns pets while it runs, the last spreads its pets over a hundred
+	// windows, so every pass submits them all for the few in sight
+	struct Case {
+		size_t pets;
+		double simRate;
+		bool churning;
+		float range = 10.0f;
+	};
+	int failures = 0;
+	for (Case run : {Case{1, 60.0, false}, Case{3, 60.0, false}, Case{10, 60.0, false}, Case{100, 60.0, false}, Case{100, 20.0, false}, Case{100, 20.0, true},
+		Case{1000, 60.0, false, 1000.0f}}) {
+		RunResult full = runFull(context, resources, projection, run.pets, frames, run.simRate, run.range, run.churning);
+		RunResult tracked = runDamage(context, resources, projection, run.pets, frames, run.simRate, run.range, run.churning, verify);
+
+		std::cout << run.pets << " pets, " << run.simRate << " Hz simulation" << (run.churning ? ", spawning and despawning" : "")
+			<< (run.range != 10.0f ? ", most out of sight" : "") << std::endl;
+		print("every vsync: ", full, frames, context.getWidth(), context.getHeight());
+		print("on change:   ", tracked, frames, context.getWidth(), context.getHeight());
+		std::cout << "  " << full.seconds / tracked.seconds << "x less time, " << tracked.fullRedraws << " full redraws, "
+			<< tracked.overFullCost << " frames costing more than one";
+		if (verify) {
+			std::cout << ", " << tracked.mismatchedFrames << " frames differ from a full redraw";
+		}
+		std::cout << std::endl;
+		failures += tracked.mismatchedFrames + tracked.overFullCost;
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// cost of the spatial grid behind pet avoidance and following: building it, moving pets in it and
+// querying it, against checking every pair, then what turning the social behaviors on adds to a tick
+// pets stand on the app's strip or spread out at a fixed density, the per pet costs should stay flat
+
+// core
+#include "core/Random.h"
+#include "core/SpatialGrid.h"
+#include "core/World.h"
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+	constexpr float personalSpace = 0.3f;
+	constexpr float followRadius = 2.0f;
+	constexpr int maxNeighbours = 32; // the world's cap per query
+
+	double secondsSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	struct Layout {
+		const char* name;
+		float width;
+	};
+
+	// the neighbour queries the world makes, a blocker ahead within personalSpace and the nearest pet within followRadius
+	bool isBlocked(const SpatialGrid& grid, uint32_t index, float x, float y) {
+		bool blocked = false;
+		int visited = 0;
+		grid.query(x, y, personalSpace, [&](uint32_t other, float otherX, float otherY) {
+			float dx = otherX - x, dy = otherY - y;
+			if (other != index && dx > 0.0f && dx * dx + dy * dy < personalSpace * personalSpace) {
+				blocked = true;
+				return false;
+			}
+			return ++visited < maxNeighbours;
+		});
+		return blocked;
+	}
+
+	uint32_t findNearest(const SpatialGrid& grid, uint32_t index, float x, float y) {
+		uint32_t nearest = SpatialGrid::none;
+		float nearestDistance = followRadius * followRadius;
+		int visited = 0;
+		grid.query(x, y, followRadius, [&](uint32_t other, float otherX, float otherY) {
+			float distance = (otherX - x) * (otherX - x) + (otherY - y) * (otherY - y);
+			if (other != index && distance < nearestDistance) {
+				nearest = other;
+				nearestDistance = distance;
+			}
+			return ++visited < maxNeighbours;
+		});
+		return nearest;
+	}
+
+	void benchGrid(size_t pets, const Layout& layout) {
+		RandomStream random(1, 0);
+		std::vector<float> x(pets), y(pets, 0.0f);
+		for (size_t i = 0; i < pets; ++i) {
+			x[i] = random.nextFloat(-layout.width / 2, layout.width / 2);
+		}
+
+		SpatialGrid grid;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < pets; ++i) {
+			grid.update((uint32_t)i, x[i], y[i]);
+		}
+		double build = secondsSince(start);
+
+		// a tick at 60 Hz with a tenth of the pets walking
+		size_t walkers = pets / 10;
+		int ticks = 60;
+		start = std::chrono::steady_clock::now();
+		for (int tick = 0; tick < ticks; ++tick) {
+			for (size_t i = 0; i < walkers; ++i) {
+				x[i * 10] += 0.5f / 60.0f;
+				grid.update((uint32_t)(i * 10), x[i * 10], y[i * 10]);
+			}
+		}
+		double update = secondsSince(start);
+
+		size_t blocked = 0, found = 0, naiveFound = 0;
+		start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < pets; ++i) {
+			blocked += isBlocked(grid, (uint32_t)i, x[i], y[i]);
+		}
+		double blockQuery = secondsSince(start);
+		start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < pets; ++i) {
+			found += findNearest(grid, (uint32_t)i, x[i], y[i]) != SpatialGrid::none;
+		}
+		double nearestQuery = secondsSince(start);
+
+		// every pet against all others, only for a sample of pets, the whole population would take n squared
+		double naive = 0.0;
+		size_t naiveQueries = std::min<size_t>(pets, 2000);
+		{
+			start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < naiveQueries; ++i) {
+				float nearestDistance = followRadius * followRadius;
+				size_t nearest = pets;
+				for (size_t j = 0; j < pets; ++j) {
+					float distance = (x[j] - x[i]) * (x[j] - x[i]) + (y[j] - y[i]) * (y[j] - y[i]);
+					if (j != i && distance < nearestDistance) {
+						nearest = j;
+						nearestDistance = distance;
+					}
+				}
+				naiveFound += nearest != pets;
+			}
+			naive = secondsSince(start);
+		}
+
+		std::cout << "  " << pets << " pets: build " << build / pets * 1e9 << " ns/pet, move " << update / (walkers * ticks) * 1e9 << " ns/walker, "
+			<< "blocker query " << blockQuery / pets * 1e9 << " ns, nearest query " << nearestQuery / pets * 1e9 << " ns, "
+			<< "every pair " << naive / naiveQueries * 1e9 << " ns (" << blocked * 100 / pets << "% blocked, "
+			<< found * 100 / pets << "% and " << naiveFound * 100 / naiveQueries << "% found a neighbour)" << std::endl;
+	}
+
+	double benchTick(size_t pets, bool social, double seconds) {
+		WorldSettings settings;
+		settings.seed = 1;
+		settings.social.enabled = social;
+		World world(settings);
+		for (size_t i = 0; i < pets; ++i) {
+			world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+		}
+		for (int i = 0; i < 30 * 60; ++i) {
+			world.step(settings.timestep);
+		}
+
+		int ticks = (int)(seconds * 60.0);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ticks; ++i) {
+			world.step(settings.timestep);
+		}
+		return secondsSince(start) / ticks;
+	}
+}
+
+// grid_bench [seconds]
+int main(int argc, char* argv[]) {
+	double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+
+	for (Layout layout : {Layout{"on the app's 10 unit strip", 10.0f}, Layout{"spread out, 100 per unit", 0.0f}}) {
+		std::cout << "grid, pets " << layout.name << std::endl;
+		for (size_t pets : {1000, 10000, 100000}) {
+			Layout scaled = layout;
+			if (scaled.width == 0.0f) {
+				scaled.width = pets / 100.0f;
+			}
+			benchGrid(pets, scaled);
+		}
+	}
+
+	std::cout << "tick, " << seconds << " s at 60 Hz after 30 s to settle" << std::endl;
+	for (size_t pets : {1000, 10000, 100000}) {
+		double alone = benchTick(pets, false, seconds);
+		double social = benchTick(pets, true, seconds);
+		std::cout << "  " << pets << " pets: " << alone * 1e6 << " us/tick alone, " << social * 1e6 << " us/tick avoiding and following, "
+			<< social / pets * 1e9 << " ns/pet" << std::endl;
+	}
+	return 0;
+}
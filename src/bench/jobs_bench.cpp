@@ -0,0 +1,106 @@
+// steps and fast-forwards a large population over 1 to 32 job system threads, every thread count
+// has to end in exactly the state the single threaded run does
+
+// core
+#include "core/JobSystem.h"
+#include "core/World.h"
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+// FNV-1a over what stepping changes, like capybara_sim's checksum
+uint64_t checksum(const World& world) {
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* data, size_t size) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+
+	const Population& population = world.getPopulation();
+	for (size_t i = 0; i < population.size(); ++i) {
+		mix(&population.positionX[i], sizeof(float));
+		mix(&population.positionY[i], sizeof(float));
+		mix(&population.state[i], sizeof(uint8_t));
+		mix(&population.stateStartTick[i], sizeof(uint64_t));
+		mix(&population.random[i].counter, sizeof(uint64_t));
+	}
+	return hash;
+}
+
+void spawn(World& world, size_t pets) {
+	for (size_t i = 0; i < pets; ++i) {
+		world.spawn(glm::vec2(world.randomFloat(-5.0f, 5.0f), 0.0f), glm::vec2(0.5f, 0.5f));
+	}
+}
+
+struct RunResult {
+	double stepSeconds = 0.0;
+	double advanceSeconds = 0.0;
+	uint64_t stepChecksum = 0;
+	uint64_t advanceChecksum = 0;
+	uint64_t steals = 0;
+};
+
+// threads 0 runs without a job system
+RunResult run(unsigned threads, size_t pets, int ticks, size_t advancedPets, double advanceHours) {
+	RunResult result;
+	JobSystem jobs(threads == 0 ? 1 : threads);
+
+	WorldSettings settings;
+	settings.seed = 1;
+	World stepped(settings);
+	if (threads > 0) {
+		stepped.setJobSystem(&jobs);
+	}
+	spawn(stepped, pets);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < ticks; ++i) {
+		stepped.step(settings.timestep);
+	}
+	result.stepSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.stepChecksum = checksum(stepped);
+
+	World advanced(settings);
+	if (threads > 0) {
+		advanced.setJobSystem(&jobs);
+	}
+	spawn(advanced, advancedPets);
+	start = std::chrono::steady_clock::now();
+	advanced.advance(advanceHours * 3600.0);
+	result.advanceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.advanceChecksum = checksum(advanced);
+	result.steals = jobs.getSteals();
+	return result;
+}
+
+// jobs_bench [pets] [ticks] [pets to advance] [hours]
+int main(int argc, char* argv[]) {
+	size_t pets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	int ticks = argc > 2 ? std::atoi(argv[2]) : 600;
+	size_t advancedPets = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000;
+	double hours = argc > 4 ? std::atof(argv[4]) : 1.0;
+
+	std::cout << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+	std::cout << "stepping " << pets << " pets for " << ticks << " ticks, advancing " << advancedPets << " pets by " << hours << " h" << std::endl;
+
+	RunResult serial = run(0, pets, ticks, advancedPets, hours);
+	std::cout << "no job system: " << serial.stepSeconds / ticks * 1e3 << " ms/tick, advance " << serial.advanceSeconds * 1e3 << " ms" << std::endl;
+
+	int mismatches = 0;
+	for (unsigned threads : {1, 2, 4, 8, 16, 32}) {
+		RunResult result = run(threads, pets, ticks, advancedPets, hours);
+		bool same = result.stepChecksum == serial.stepChecksum && result.advanceChecksum == serial.advanceChecksum;
+		mismatches += !same;
+		std::cout << threads << " threads: " << result.stepSeconds / ticks * 1e3 << " ms/tick ("
+			<< serial.stepSeconds / result.stepSeconds << "x), advance " << result.advanceSeconds * 1e3 << " ms ("
+			<< serial.advanceSeconds / result.advanceSeconds << "x), " << result.steals << " chunks stolen, "
+			<< (same ? "same state" : "DIFFERENT STATE") << std::endl;
+	}
+	return mismatches == 0 ? 0 : 1;
+}
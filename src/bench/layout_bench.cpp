@@ -0,0 +1,109 @@
+// heap bytes each pet costs the simulation and the snapshot drawing reads, and how fast a frame
+// gets through a large population: stepping it, capturing a snapshot, reading back what drawing
+// needs of every pet and tracking damage, blended at 60 Hz over a 20 Hz simulation like the app
+
+// core
+#include "core/Allocations.h"
+#include "core/Snapshot.h"
+#include "core/World.h"
+
+// render
+#include "render/DamageTracker.h"
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+uint64_t getAllocatedBytes() {
+	return Allocations::getThreadCounts().bytes;
+}
+
+// everything the damage tracker and the renderer look at per pet, folded so none of it is optimized out
+float readPets(const RenderView& view) {
+	float sum = 0.0f;
+	for (size_t i = 0; i < view.size(); ++i) {
+		glm::vec2 position = view.getPosition(i);
+		sum += position.x + position.y + view.getScale(i).x + (float)view.getFrameIndex(i);
+		sum += (float)view.isFlipped(i) + (float)view.isMoving(i) + (float)(view.getSlot(i) & 1);
+	}
+	return sum;
+}
+
+// layout_bench [pets] [seconds]
+int main(int argc, char* argv[]) {
+	size_t pets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+
+	if (!Allocations::isTracking()) {
+		std::cout << "error counting | operator new | The allocation hook isn't linked in." << std::endl;
+		return 1;
+	}
+
+	WorldSettings settings;
+	settings.seed = 1;
+	settings.timestep = 1.0 / 20.0;
+	settings.capacity = (uint32_t)pets;
+
+	// capacity is reserved up front, so what the world allocates is what it keeps
+	uint64_t before = getAllocatedBytes();
+	World world(settings);
+	for (size_t i = 0; i < pets; ++i) {
+		world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+	}
+	double worldBytes = (double)(getAllocatedBytes() - before) / pets;
+
+	before = getAllocatedBytes();
+	WorldSnapshot snapshot;
+	snapshot.capture(world);
+	double snapshotBytes = (double)(getAllocatedBytes() - before) / pets;
+
+	std::cout << pets << " pets, " << seconds << " s at 60 Hz after 30 s to settle" << std::endl;
+	std::cout << "memory:   " << worldBytes << " bytes per pet in the world, " << snapshotBytes << " in a snapshot" << std::endl;
+
+	// a wide strip like the app's window
+	int width = 1920, height = 147;
+	float aspectRatio = (float)width / (float)height;
+	glm::mat4 projection = glm::ortho(-5.0f, 5.0f, -5.0f / aspectRatio, 5.0f / aspectRatio, -1.0f, 1.0f);
+	DamageTracker damage;
+
+	constexpr uint64_t frameNanoseconds = 1000000000ull / 60;
+	for (int i = 0; i < 30 * 60; ++i) {
+		world.stepNanoseconds(frameNanoseconds);
+	}
+
+	using Clock = std::chrono::steady_clock;
+	double stepSeconds = 0.0, captureSeconds = 0.0, readSeconds = 0.0, damageSeconds = 0.0;
+	float readSum = 0.0f;
+	uint64_t ticks = 0;
+	int frames = (int)(seconds * 60.0);
+	for (int i = 0; i < frames; ++i) {
+		auto start = Clock::now();
+		int stepped = world.stepNanoseconds(frameNanoseconds);
+		auto stepEnd = Clock::now();
+		if (stepped > 0) {
+			snapshot.capture(world);
+		}
+		auto captureEnd = Clock::now();
+		RenderView view(snapshot, world.getBlend());
+		readSum += readPets(view);
+		auto readEnd = Clock::now();
+		damage.update(view, projection, width, height);
+		auto damageEnd = Clock::now();
+
+		ticks += stepped;
+		stepSeconds += std::chrono::duration<double>(stepEnd - start).count();
+		captureSeconds += std::chrono::duration<double>(captureEnd - stepEnd).count();
+		readSeconds += std::chrono::duration<double>(readEnd - captureEnd).count();
+		damageSeconds += std::chrono::duration<double>(damageEnd - readEnd).count();
+	}
+
+	std::cout << "step:     " << stepSeconds / ticks * 1e3 << " ms per tick, " << pets * ticks / stepSeconds / 1e6 << "M pets per second" << std::endl;
+	std::cout << "capture:  " << captureSeconds / ticks * 1e3 << " ms per tick, " << pets * ticks / captureSeconds / 1e6 << "M pets per second" << std::endl;
+	std::cout << "read:     " << readSeconds / frames * 1e3 << " ms per frame, " << pets * frames / readSeconds / 1e6 << "M pets per second (" << readSum << ")" << std::endl;
+	std::cout << "damage:   " << damageSeconds / frames * 1e3 << " ms per frame, " << pets * frames / damageSeconds / 1e6 << "M pets per second" << std::endl;
+	return 0;
+}
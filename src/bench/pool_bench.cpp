@@ -0,0 +1,111 @@
+// spawning and despawning pets while the world runs, the pool is reserved up front so neither
+// reallocates, the worst tick with pets coming and going is compared against one without
+
+// core
+#include "core/Timing.h"
+#include "core/World.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+struct RunResult {
+	TimingStats ticks;
+	double spawnSeconds = 0.0;
+	double despawnSeconds = 0.0;
+	size_t spawns = 0;
+	size_t despawns = 0;
+};
+
+double getSeconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint64_t getNanoseconds(std::chrono::steady_clock::time_point start) {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+PetHandle spawnPet(World& world) {
+	const WorldSettings& settings = world.getSettings();
+	return world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+}
+
+// churn pets leave and as many arrive every tick, picked at random like a dashboard's events would
+RunResult run(World& world, int ticks, size_t churn) {
+	RunResult result;
+	for (int i = 0; i < ticks; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		for (size_t j = 0; j < churn && world.size() > 0; ++j) {
+			size_t index = std::min((size_t)world.randomFloat(0.0f, (float)world.size()), world.size() - 1);
+			auto despawnStart = std::chrono::steady_clock::now();
+			world.despawn(world.getHandle(index));
+			result.despawnSeconds += getSeconds(despawnStart);
+			++result.despawns;
+		}
+		for (size_t j = 0; j < churn; ++j) {
+			auto spawnStart = std::chrono::steady_clock::now();
+			spawnPet(world);
+			result.spawnSeconds += getSeconds(spawnStart);
+			++result.spawns;
+		}
+		world.step(world.getSettings().timestep);
+		result.ticks.add(getNanoseconds(start));
+	}
+	return result;
+}
+
+// pool_bench [capacity] [seconds] [churn per tick]
+int main(int argc, char* argv[]) {
+	size_t capacity = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+	size_t churn = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100;
+	int ticks = (int)(seconds * 60.0);
+
+	WorldSettings settings;
+	settings.seed = 1;
+	settings.capacity = (uint32_t)capacity;
+	int failures = 0;
+
+	for (bool social : {false, true}) {
+		settings.social.enabled = social;
+		World world(settings);
+		const Population& population = world.getPopulation();
+		const float* positions = population.positionX.data();
+		const uint32_t* slots = population.slot.data();
+
+		// half full, the churn keeps it there
+		for (size_t i = 0; i < capacity / 2; ++i) {
+			spawnPet(world);
+		}
+		run(world, 10 * 60, 0);
+
+		RunResult still = run(world, ticks, 0);
+		RunResult churning = run(world, ticks, churn);
+
+		std::cout << capacity / 2 << " of " << capacity << " pets" << (social ? ", social" : "") << ", " << seconds << " s at 60 Hz" << std::endl;
+		std::cout << "  no churn:          " << still.ticks.getMean() << " ms/tick mean, " << still.ticks.getMax() << " ms worst" << std::endl;
+		std::cout << "  " << churn << " in, " << churn << " out:    " << churning.ticks.getMean() << " ms/tick mean, " << churning.ticks.getMax() << " ms worst" << std::endl;
+		std::cout << "  spawn " << churning.spawnSeconds / churning.spawns * 1e9 << " ns, despawn " << churning.despawnSeconds / churning.despawns * 1e9 << " ns" << std::endl;
+
+		// filling up to capacity never moves the arrays, one more fails
+		while (world.size() < capacity) {
+			spawnPet(world);
+		}
+		bool full = spawnPet(world).isNull();
+		bool stayed = population.positionX.data() == positions && population.slot.data() == slots;
+
+		// a despawned pet's slot is taken by the next spawn, the old handle must not reach the new pet
+		PetHandle old = world.getHandle(capacity / 3);
+		world.despawn(old);
+		PetHandle reused = spawnPet(world);
+		bool stale = reused.slot == old.slot && !world.isAlive(old) && world.getIndex(old) == world.size() && !world.despawn(old) && world.isAlive(reused);
+
+		std::cout << "  full at capacity: " << (full ? "yes" : "no") << ", arrays reallocated: " << (stayed ? "no" : "yes")
+			<< ", stale handle rejected: " << (stale ? "yes" : "no") << std::endl;
+		failures += !full + !stayed + !stale;
+	}
+	return failures == 0 ? 0 : 1;
+}
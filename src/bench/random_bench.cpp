@@ -0,0 +1,71 @@
+// compares the per frame cost of the old getRandomFloat with per pet counter based streams
+
+// core
+#include "core/Random.h"
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// what main.mm used to do for every draw
+float legacyRandomFloat(float lower, float upper) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_real_distribution<> distrib(lower, upper);
+	return distrib(gen);
+}
+
+template<typename Function>
+double secondsPerFrame(int frames, Function&& frame) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; ++i) {
+		frame();
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(end - start).count() / frames;
+}
+
+int main(int argc, char* argv[]) {
+	size_t pets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+
+	// an idle pet drew two numbers a frame, the next state roll and the idle threshold
+	std::vector<float> nextState(pets), threshold(pets);
+	float sink = 0.0f;
+
+	double legacy = secondsPerFrame(10, [&]() {
+		for (size_t i = 0; i < pets; ++i) {
+			nextState[i] = legacyRandomFloat(0.0f, 1.0f);
+			threshold[i] = legacyRandomFloat(3.0f, 6.0f);
+		}
+		sink += nextState[0] + threshold[pets - 1];
+	});
+
+	std::vector<RandomStream> streams(pets);
+	for (size_t i = 0; i < pets; ++i) {
+		streams[i] = RandomStream(1, i);
+	}
+
+	double scalar = secondsPerFrame(1000, [&]() {
+		for (size_t i = 0; i < pets; ++i) {
+			nextState[i] = streams[i].nextFloat();
+			threshold[i] = streams[i].nextFloat(3.0f, 6.0f);
+		}
+		sink += nextState[0] + threshold[pets - 1];
+	});
+
+	double batch = secondsPerFrame(1000, [&]() {
+		fillUniforms(streams.data(), nextState.data(), pets);
+		fillUniforms(streams.data(), threshold.data(), pets, 3.0f, 6.0f);
+		sink += nextState[0] + threshold[pets - 1];
+	});
+
+	std::cout << "pets:                  " << pets << std::endl;
+	std::cout << "random_device + mt19937: " << legacy * 1e3 << " ms/frame" << std::endl;
+	std::cout << "RandomStream scalar:     " << scalar * 1e3 << " ms/frame (" << legacy / scalar << "x)" << std::endl;
+	std::cout << "fillUniforms batch:      " << batch * 1e3 << " ms/frame (" << legacy / batch << "x)" << std::endl;
+	std::cout << "(" << sink << ")" << std::endl;
+	return 0;
+}
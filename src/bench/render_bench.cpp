@@ -0,0 +1,118 @@
+// compares submitting every pet on its own with the instanced SpriteRenderer, under a headless software context
+
+// core
+#include "core/Snapshot.h"
+#include "core/World.h"
+
+// render
+#include "render/Debug.h"
+#include "render/SpriteRenderer.h"
+
+// bench
+#include "bench/HeadlessContext.h"
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+struct FrameResult {
+	RenderStats stats;
+	double frameSeconds = 0.0; // submit plus waiting for the GPU to finish
+};
+
+template<typename Draw>
+FrameResult measure(int frames, World& world, WorldSnapshot& snapshot, Draw&& draw) {
+	FrameResult result;
+	for (int i = 0; i < frames; ++i) {
+		world.step(1.0 / 60.0);
+		snapshot.capture(world);
+
+		auto start = std::chrono::steady_clock::now();
+		glClear(GL_COLOR_BUFFER_BIT);
+		RenderStats stats = draw();
+		glFinish();
+		result.frameSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		result.stats.drawCalls = stats.drawCalls;
+		result.stats.instances = stats.instances;
+		result.stats.submitSeconds += stats.submitSeconds;
+		result.stats.uploadedBytes += stats.uploadedBytes;
+	}
+	result.stats.submitSeconds /= frames;
+	result.stats.uploadedBytes /= frames;
+	result.frameSeconds /= frames;
+	return result;
+}
+
+void print(const char* name, const FrameResult& result) {
+	std::cout << "  " << name << result.stats.drawCalls << " draw calls, "
+		<< result.stats.uploadedBytes / 1024 << " KiB uploaded, "
+		<< result.stats.submitSeconds * 1e3 << " ms submit, "
+		<< result.frameSeconds * 1e3 << " ms frame" << std::endl;
+}
+
+// render_bench [frames] [off|poll|callback], the gl debug mode only takes effect in CAPYBARA_GL_DEBUG builds
+int main(int argc, char* argv[]) {
+	int frames = argc > 1 ? std::atoi(argv[1]) : 5;
+	GLDebugMode debugMode = Debug::getMode();
+	if (argc > 2) {
+		debugMode = std::strcmp(argv[2], "callback") == 0 ? GLDebugMode::Callback
+			: std::strcmp(argv[2], "poll") == 0 ? GLDebugMode::Poll
+			: GLDebugMode::Off;
+	}
+
+	// same shape as the app's window on a 1080p display
+	HeadlessContext context(1920, 1080 / 13);
+	if (!context.isValid()) {
+		return 1;
+	}
+
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+	float aspectRatio = (float)context.getWidth() / (float)context.getHeight();
+	float orthoWidth = 10.0f;
+	float orthoHeight = orthoWidth / aspectRatio;
+	glm::mat4 projection = glm::ortho(-orthoWidth / 2, orthoWidth / 2, -orthoHeight / 2, orthoHeight / 2, -1.0f, 1.0f);
+
+	debugMode = Debug::setMode(debugMode, (GLADloadproc)eglGetProcAddress);
+
+	ResourceRegistry resources(CAPYBARA_RESOURCE_DIR);
+	SpriteRenderer renderer(resources);
+	std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+#ifdef CAPYBARA_GL_DEBUG
+	std::cout << "gl debug: " << Debug::getModeName(debugMode) << std::endl;
+#else
+	std::cout << "gl debug: compiled out" << std::endl;
+#endif
+
+	for (size_t pets : {1000, 10000, 50000}) {
+		World world;
+		for (size_t i = 0; i < pets; ++i) {
+			world.spawn(glm::vec2(world.randomFloat(-5.0f, 5.0f), 0.0f), glm::vec2(0.5f, 0.5f));
+		}
+
+		// settle into a mix of states first, frame averages below are steady state
+		for (int i = 0; i < 600; ++i) {
+			world.step(1.0 / 60.0);
+		}
+
+		// drawn from a snapshot like on the app's render thread, capturing isn't timed
+		WorldSnapshot snapshot;
+		std::cout << pets << " pets" << std::endl;
+		print("per pet:   ", measure(frames, world, snapshot, [&]() { return renderer.drawPerPet(snapshot, projection); }));
+		print("instanced: ", measure(frames, world, snapshot, [&]() { return renderer.draw(snapshot, projection); }));
+	}
+
+	if (Debug::getMessageCount() > 0) {
+		std::cout << Debug::getMessageCount() << " OpenGL debug messages" << std::endl;
+	}
+	return 0;
+}
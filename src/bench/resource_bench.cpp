@@ -0,0 +1,147 @@
+// counts the GL objects and driver memory the renderer holds as pets are added, and checks that
+// creating and destroying renderers and canvases leaves nothing behind, under a headless context
+
+// core
+#include "core/Snapshot.h"
+#include "core/World.h"
+
+// render
+#include "render/Canvas.h"
+#include "render/GLObject.h"
+#include "render/ResourceRegistry.h"
+#include "render/SpriteRenderer.h"
+
+// bench
+#include "bench/HeadlessContext.h"
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+// what the driver reports, found by asking it about every name up to a bound instead of trusting the wrappers
+struct DriverObjects {
+	size_t textures = 0, buffers = 0, vertexArrays = 0, programs = 0, framebuffers = 0;
+	size_t textureBytes = 0, bufferBytes = 0;
+
+	size_t getCount() const { return textures + buffers + vertexArrays + programs + framebuffers; }
+	bool operator==(const DriverObjects& other) const = default;
+};
+
+// names are handed out from 1 up and reused after deletion, a few thousand is far past what is ever alive
+constexpr GLuint probedNames = 4096;
+
+DriverObjects countDriverObjects() {
+	DriverObjects objects;
+	for (GLuint id = 1; id <= probedNames; ++id) {
+		if (glIsTexture(id)) {
+			GLint width = 0, height = 0;
+			glBindTexture(GL_TEXTURE_2D, id);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			++objects.textures;
+			objects.textureBytes += (size_t)width * height * 4;
+		}
+		if (glIsBuffer(id)) {
+			GLint size = 0;
+			glBindBuffer(GL_ARRAY_BUFFER, id);
+			glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			++objects.buffers;
+			objects.bufferBytes += (size_t)size;
+		}
+		objects.vertexArrays += glIsVertexArray(id);
+		objects.programs += glIsProgram(id);
+		objects.framebuffers += glIsFramebuffer(id);
+	}
+	return objects;
+}
+
+void print(const char* name, const DriverObjects& objects) {
+	std::cout << name << objects.getCount() << " driver objects (" << objects.textures << " textures, " << objects.buffers << " buffers, "
+		<< objects.vertexArrays << " vertex arrays, " << objects.programs << " programs, " << objects.framebuffers << " framebuffers), "
+		<< objects.textureBytes / 1024 << " KiB textures, " << objects.bufferBytes / 1024 << " KiB buffers, "
+		<< getLiveGLObjectCount() << " owned by wrappers" << std::endl;
+}
+
+// resource_bench [cycles]
+int main(int argc, char* argv[]) {
+	int cycles = argc > 1 ? std::atoi(argv[1]) : 100;
+
+	HeadlessContext context(1920, 1080 / 13);
+	if (!context.isValid()) {
+		return 1;
+	}
+	std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+	float aspectRatio = (float)context.getWidth() / (float)context.getHeight();
+	glm::mat4 projection = glm::ortho(-5.0f, 5.0f, -5.0f / aspectRatio, 5.0f / aspectRatio, -1.0f, 1.0f);
+
+	// the context's own framebuffer is all there is before anything is created
+	DriverObjects baseline = countDriverObjects();
+	print("before: ", baseline);
+	int failures = 0;
+
+	// two renderers share one quad, atlas and shader, adding pets only grows the instance buffers
+	{
+		ResourceRegistry resources(CAPYBARA_RESOURCE_DIR);
+		SpriteRenderer renderer(resources), second(resources);
+		Canvas canvas;
+		canvas.resize(context.getWidth(), context.getHeight());
+
+		World world;
+		size_t objectCount = 0;
+		for (size_t pets : {1, 10, 1000, 100000}) {
+			while (world.size() < pets) {
+				world.spawn(glm::vec2(world.randomFloat(-5.0f, 5.0f), 0.0f), glm::vec2(0.5f, 0.5f));
+			}
+			world.step(1.0 / 60.0);
+			WorldSnapshot snapshot;
+			snapshot.capture(world);
+			canvas.bind();
+			renderer.draw(snapshot, projection);
+			second.draw(snapshot, projection);
+			glFinish();
+
+			DriverObjects objects = countDriverObjects();
+			print((std::to_string(pets) + " pets: ").c_str(), objects);
+			if (objectCount != 0 && objects.getCount() != objectCount) {
+				++failures;
+			}
+			objectCount = objects.getCount();
+		}
+		canvas.destroy();
+	}
+	DriverObjects after = countDriverObjects();
+	print("destroyed: ", after);
+	failures += !(after == baseline) + (getLiveGLObjectCount() != 0);
+
+	// moving a texture or a shader hands the name over, it is deleted once by whichever holds it last
+	for (int i = 0; i < cycles; ++i) {
+		ResourceRegistry resources(CAPYBARA_RESOURCE_DIR);
+		SpriteRenderer renderer(resources);
+		Canvas canvas;
+		canvas.resize(context.getWidth(), context.getHeight() + i % 2);
+		Texture moved = Texture(4, 4, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+		Texture target = std::move(moved);
+		Shader shader = Shader(std::string(CAPYBARA_RESOURCE_DIR) + "/res/shader/vert.vert", std::string(CAPYBARA_RESOURCE_DIR) + "/res/shader/frag.frag");
+		Shader shaderTarget;
+		shaderTarget = std::move(shader);
+	}
+	after = countDriverObjects();
+	print((std::to_string(cycles) + " cycles: ").c_str(), after);
+	failures += !(after == baseline) + (getLiveGLObjectCount() != 0);
+
+	GLenum error = glGetError();
+	if (error != GL_NO_ERROR) {
+		std::cout << "OpenGL error " << error << std::endl;
+		++failures;
+	}
+	std::cout << (failures == 0 ? "no leaks" : "leaked") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// compares drawing on the simulation's thread with drawing on a render thread fed snapshots through
+// a triple buffer, under a headless software context with vsync and the occasional slow swap faked
+// by sleeping, reports input to photon latency and frame time jitter for each thread
+
+// core
+#include "core/Clock.h"
+#include "core/Snapshot.h"
+#include "core/Timing.h"
+#include "core/TripleBuffer.h"
+#include "core/World.h"
+
+// render
+#include "render/Canvas.h"
+#include "render/DamageTracker.h"
+#include "render/SpriteRenderer.h"
+
+// bench
+#include "bench/HeadlessContext.h"
+
+// glm
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace {
+	constexpr uint64_t refreshNanoseconds = 16666667;
+
+	struct Options {
+		size_t pets = 100;
+		double seconds = 5.0;
+		uint64_t stallNanoseconds = 40000000; // a swap this much slower than the refresh
+		int stallEvery = 30;                  // presents
+	};
+
+	// what the simulation hands the render thread
+	struct Frame {
+		WorldSnapshot world;
+		uint64_t inputNanoseconds = 0;
+	};
+
+	struct RunResult {
+		TimingStats simFrames;    // between steps
+		TimingStats renderFrames; // between presents
+		TimingStats latency;      // from reading input to the swap returning
+		uint64_t published = 0;
+		uint64_t presents = 0;
+		uint64_t ticks = 0;
+	};
+
+	void spawn(World& world, size_t pets) {
+		for (size_t i = 0; i < pets; ++i) {
+			world.spawn(glm::vec2(world.randomFloat(-5.0f, 5.0f), 0.0f), glm::vec2(0.5f, 0.5f));
+		}
+	}
+
+	// blocks until the next refresh like a swap with vsync on, every stallEvery-th one takes longer
+	void swap(const Clock& clock, const Options& options, uint64_t presents) {
+		uint64_t now = clock.getNanoseconds();
+		uint64_t vsync = (now / refreshNanoseconds + 1) * refreshNanoseconds;
+		if (presents % options.stallEvery == (uint64_t)options.stallEvery - 1) {
+			vsync += options.stallNanoseconds;
+		}
+		std::this_thread::sleep_for(std::chrono::nanoseconds(vsync - now));
+	}
+
+	class Presenter {
+	public:
+		Presenter(HeadlessContext& context, const glm::mat4& projection) : resources(CAPYBARA_RESOURCE_DIR), renderer(resources), context(context), projection(projection) {
+			canvas.resize(context.getWidth(), context.getHeight());
+		}
+		~Presenter() { canvas.destroy(); }
+
+		// draws what changed and swaps, returns false when nothing did
+		bool present(const RenderView& view) {
+			if (!damage.update(view, projection, canvas.getWidth(), canvas.getHeight())) {
+				return false;
+			}
+			canvas.bind();
+			renderer.draw(view, projection, damage.getRects());
+			canvas.present(context.getFramebufferID());
+			glFinish();
+			return true;
+		}
+
+	private:
+		ResourceRegistry resources;
+		SpriteRenderer renderer;
+		Canvas canvas;
+		DamageTracker damage;
+		HeadlessContext& context;
+		glm::mat4 projection;
+	};
+
+	// the loop the app had, a slow swap holds back the next step
+	RunResult runSerial(HeadlessContext& context, const glm::mat4& projection, const Options& options) {
+		World world;
+		spawn(world, options.pets);
+		Presenter presenter(context, projection);
+		Clock clock;
+		// drawing reads pets from a snapshot, here captured on the same thread right before
+		WorldSnapshot snapshot;
+
+		RunResult result;
+		uint64_t end = (uint64_t)(options.seconds * 1e9);
+		uint64_t last = clock.getNanoseconds(), lastStep = 0, lastPresent = 0;
+		while (last < end) {
+			uint64_t input = clock.getNanoseconds();
+			if (world.stepNanoseconds(input - last) > 0) {
+				if (lastStep) {
+					result.simFrames.add(input - lastStep);
+				}
+				lastStep = input;
+			}
+			last = input;
+
+			snapshot.capture(world);
+			if (presenter.present(snapshot)) {
+				swap(clock, options, result.presents++);
+				uint64_t presented = clock.getNanoseconds();
+				result.latency.add(presented - input);
+				if (lastPresent) {
+					result.renderFrames.add(presented - lastPresent);
+				}
+				lastPresent = presented;
+			}
+		}
+		result.ticks = world.getTickCount();
+		return result;
+	}
+
+	// the simulation steps on this thread at its own rate while the render thread draws the newest snapshot
+	RunResult runThreaded(HeadlessContext& context, const glm::mat4& projection, const Options& options) {
+		World world;
+		spawn(world, options.pets);
+		Clock clock;
+		TripleBuffer<Frame> frames;
+		std::atomic<bool> running{true};
+
+		RunResult result;
+		context.release();
+		std::thread renderThread([&]() {
+			context.makeCurrent();
+			{
+				Presenter presenter(context, projection);
+				uint64_t lastPresent = 0;
+				while (running.load(std::memory_order_acquire)) {
+					frames.wait();
+					if (!frames.take()) {
+						continue;
+					}
+					const Frame& frame = frames.getFront();
+					if (presenter.present(frame.world)) {
+						swap(clock, options, result.presents++);
+						uint64_t presented = clock.getNanoseconds();
+						result.latency.add(presented - frame.inputNanoseconds);
+						if (lastPresent) {
+							result.renderFrames.add(presented - lastPresent);
+						}
+						lastPresent = presented;
+					}
+				}
+			}
+			context.release();
+		});
+
+		uint64_t end = (uint64_t)(options.seconds * 1e9);
+		uint64_t last = clock.getNanoseconds(), lastStep = 0;
+		while (last < end) {
+			// sleeps until the next tick is due
+			double wait = world.getTimeUntilTick(world.getTickCount() + 1);
+			std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+
+			uint64_t input = clock.getNanoseconds();
+			if (world.stepNanoseconds(input - last) > 0) {
+				if (lastStep) {
+					result.simFrames.add(input - lastStep);
+				}
+				lastStep = input;
+
+				Frame& frame = frames.getBack();
+				frame.world.capture(world);
+				frame.inputNanoseconds = input;
+				frames.publish();
+				++result.published;
+			}
+			last = input;
+		}
+
+		running.store(false, std::memory_order_release);
+		frames.wake();
+		renderThread.join();
+		context.makeCurrent();
+		result.ticks = world.getTickCount();
+		return result;
+	}
+
+	void print(const char* name, const TimingStats& stats) {
+		std::cout << "    " << name << stats.getMean() << " ms mean, " << stats.getDeviation() << " ms deviation, " << stats.getMax() << " ms worst" << std::endl;
+	}
+
+	void print(const char* name, const RunResult& result) {
+		std::cout << "  " << name << result.ticks << " ticks, " << result.presents << " presents";
+		if (result.published) {
+			std::cout << ", " << result.published << " snapshots published";
+		}
+		std::cout << std::endl;
+		print("sim frames:    ", result.simFrames);
+		print("render frames: ", result.renderFrames);
+		print("latency:       ", result.latency);
+	}
+}
+
+// thread_bench [pets] [seconds] [stall ms] [stall every n presents]
+int main(int argc, char* argv[]) {
+	Options options;
+	if (argc > 1) options.pets = (size_t)std::atoll(argv[1]);
+	if (argc > 2) options.seconds = std::atof(argv[2]);
+	if (argc > 3) options.stallNanoseconds = (uint64_t)(std::atof(argv[3]) * 1e6);
+	if (argc > 4) options.stallEvery = std::max(1, std::atoi(argv[4]));
+
+	// same shape as the app's window on a 1080p display
+	HeadlessContext context(1920, 1080 / 13);
+	if (!context.isValid()) {
+		return 1;
+	}
+
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	float aspectRatio = (float)context.getWidth() / (float)context.getHeight();
+	float orthoWidth = 10.0f;
+	float orthoHeight = orthoWidth / aspectRatio;
+	glm::mat4 projection = glm::ortho(-orthoWidth / 2, orthoWidth / 2, -orthoHeight / 2, orthoHeight / 2, -1.0f, 1.0f);
+
+	std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+	std::cout << options.pets << " pets, " << options.seconds << " s, vsync at 60 Hz, every " << options.stallEvery
+		<< "th swap " << options.stallNanoseconds * 1e-6 << " ms late" << std::endl;
+
+	print("one thread:      ", runSerial(context, projection, options));
+	print("render thread:   ", runThreaded(context, projection, options));
+	return 0;
+}
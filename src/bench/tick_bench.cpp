@@ -0,0 +1,70 @@
+// per tick cost of a large population against how many of its pets are active, shorter wander
+// ranges make shorter walks so more of the population sits waiting on a timer, the cost should
+// follow the pets moving and deciding, up to the share where sweeping everyone is cheaper
+
+// core
+#include "core/World.h"
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+size_t countMoving(const World& world) {
+	const Population& population = world.getPopulation();
+	size_t moving = 0;
+	for (size_t i = 0; i < population.size(); ++i) {
+		moving += population.velocityX[i] != 0.0f || population.velocityY[i] != 0.0f;
+	}
+	return moving;
+}
+
+// pets that entered a new state on the last tick
+size_t countDeciding(const World& world) {
+	const Population& population = world.getPopulation();
+	size_t deciding = 0;
+	for (size_t i = 0; i < population.size(); ++i) {
+		deciding += population.stateStartTick[i] + 1 == world.getTickCount();
+	}
+	return deciding;
+}
+
+// tick_bench [pets] [seconds]
+int main(int argc, char* argv[]) {
+	size_t pets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	double seconds = argc > 2 ? std::atof(argv[2]) : 20.0;
+
+	std::cout << pets << " pets, " << seconds << " s at 60 Hz after 30 s to settle" << std::endl;
+	for (float range : {10.0f, 3.0f, 1.0f, 0.3f, 0.1f, 0.0f}) {
+		WorldSettings settings;
+		settings.seed = 1;
+		settings.minX = -range / 2;
+		settings.maxX = range / 2;
+		World world(settings);
+		for (size_t i = 0; i < pets; ++i) {
+			world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+		}
+		for (int i = 0; i < 30 * 60; ++i) {
+			world.step(settings.timestep);
+		}
+
+		// the active pets are counted once a simulated second, outside the timed steps
+		double elapsed = 0.0;
+		double movingShare = 0.0;
+		double deciding = 0.0;
+		int ticks = (int)(seconds * 60.0);
+		for (int i = 0; i < ticks; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			world.step(settings.timestep);
+			elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (i % 60 == 0) {
+				movingShare += (double)countMoving(world) / pets / (ticks / 60);
+				deciding += (double)countDeciding(world) / (ticks / 60);
+			}
+		}
+
+		std::cout << "range " << range << ": " << movingShare * 100.0 << "% moving, " << deciding << " deciding per tick, "
+			<< elapsed / ticks * 1e6 << " us/tick" << std::endl;
+	}
+	return 0;
+}
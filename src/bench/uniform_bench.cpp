@@ -0,0 +1,83 @@
+// compares setting uniforms by name, the way draws used to, with reflected typed handles
+
+// render
+#include "render/Shader.h"
+
+// bench
+#include "bench/HeadlessContext.h"
+
+// std
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+template<typename Function>
+double nanosecondsPerCall(int calls, Function&& function) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < calls; ++i) {
+		function(i);
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+}
+
+int main(int argc, char* argv[]) {
+	int calls = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+	HeadlessContext context(64, 64);
+	if (!context.isValid()) {
+		return 1;
+	}
+
+	std::string resourcePath = CAPYBARA_RESOURCE_DIR;
+	Shader shader(resourcePath + "/res/shader/vert.vert", resourcePath + "/res/shader/frag.frag");
+	shader.bind();
+
+	std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+	std::cout << "reflected uniforms:";
+	for (const ShaderUniform& uniform : shader.getUniforms()) {
+		std::cout << " " << uniform.name << "@" << uniform.location;
+	}
+	std::cout << std::endl;
+
+	glm::mat4 projection(1.0f);
+
+	// what every pet used to do per draw, a string, a location query and a glGetError per uniform
+	auto legacySet = [&](const std::string& name) {
+		GLint location = glGetUniformLocation(shader.getID(), name.c_str());
+		if (glGetError() != GL_NO_ERROR) {
+			throw std::runtime_error("OpenGL error occurred");
+		}
+		return location;
+	};
+	double legacy = nanosecondsPerCall(calls, [&](int i) {
+		glUniform1i(legacySet(std::string("ourTexture")), 0);
+		glUniformMatrix4fv(legacySet("u_projection"), 1, GL_FALSE, &projection[0][0]);
+		glUniform1f(legacySet("u_time"), (float)i);
+	});
+
+	// the string setters, now answered from the reflected table
+	double byName = nanosecondsPerCall(calls, [&](int i) {
+		shader.setInt(std::string("ourTexture"), 0);
+		shader.setMatrix4Float("u_projection", &projection[0][0]);
+		shader.setFloat("u_time", (float)i);
+	});
+
+	Uniform<int> texture = shader.getUniform<int>("ourTexture");
+	Uniform<glm::mat4> projectionUniform = shader.getUniform<glm::mat4>("u_projection");
+	Uniform<float> time = shader.getUniform<float>("u_time");
+
+	double byHandle = nanosecondsPerCall(calls, [&](int i) {
+		shader.set(texture, 0);
+		shader.set(projectionUniform, projection);
+		shader.set(time, (float)i);
+	});
+
+	shader.unbind();
+
+	std::cout << "3 uniforms, location query + glGetError: " << legacy << " ns" << std::endl;
+	std::cout << "3 uniforms, cached name lookup:         " << byName << " ns (" << legacy / byName << "x)" << std::endl;
+	std::cout << "3 uniforms, typed handles:              " << byHandle << " ns (" << legacy / byHandle << "x)" << std::endl;
+	return 0;
+}
@@ -0,0 +1,86 @@
+// replays days of uptime on a 60 Hz display against the simulation clock, no window or real waiting involved
+// the old float seconds timeline is replayed next to it to show where it starts dropping and doubling ticks
+
+// core
+#include "core/World.h"
+
+// std
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+struct TimelineResult {
+	uint64_t ticks = 0;
+	uint64_t uneven = 0;        // frames that didn't run exactly one tick
+	double firstUneven = -1.0;  // uptime in seconds of the first of them
+};
+
+void countFrame(TimelineResult& result, int steps, double uptime) {
+	result.ticks += steps;
+	if (steps != 1) {
+		if (result.uneven == 0) {
+			result.firstUneven = uptime;
+		}
+		++result.uneven;
+	}
+}
+
+// uptime_bench [days]
+int main(int argc, char* argv[]) {
+	double days = argc > 1 ? std::atof(argv[1]) : 30.0;
+
+	// vsync lands half a frame off the tick grid with up to +-2 ms of jitter, every frame should run one tick
+	const double framePeriod = 1e9 / 60.0;
+	const double jitter = 2e6;
+	uint64_t frames = (uint64_t)(days * 86400.0 * 60.0);
+
+	WorldSettings settings;
+	settings.seed = 1;
+	World world(settings);
+	world.spawn(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.5f));
+	RandomStream random(settings.seed, 0);
+
+	// what the app used to do, float seconds from glfwGetTime and a double accumulator
+	float lastFrame = 0.0f;
+	double accumulator = 0.0;
+
+	TimelineResult clock, legacy;
+	uint64_t lastNanoseconds = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t frame = 0; frame < frames; ++frame) {
+		uint64_t nanoseconds = (uint64_t)((frame + 1.5) * framePeriod + random.nextFloat(-1.0f, 1.0f) * jitter);
+		double uptime = nanoseconds * 1e-9;
+
+		countFrame(clock, world.stepNanoseconds(nanoseconds - lastNanoseconds), uptime);
+		lastNanoseconds = nanoseconds;
+
+		float currentFrame = (float)uptime;
+		float dt = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+		accumulator += dt;
+		int steps = 0;
+		while (accumulator >= settings.timestep) {
+			accumulator -= settings.timestep;
+			++steps;
+		}
+		countFrame(legacy, steps, uptime);
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t expectedTicks = (uint64_t)((double)lastNanoseconds / (settings.timestep * 1e9));
+	bool exact = clock.uneven == 0 && clock.ticks == expectedTicks && world.getTickCount() == expectedTicks;
+
+	std::cout << days << " days, " << frames << " frames at 60 Hz (" << elapsed << " s)" << std::endl;
+	std::cout << "integer ns clock: " << clock.ticks << " ticks, expected " << expectedTicks << ", "
+		<< clock.uneven << " uneven frames" << std::endl;
+	std::cout << "float seconds:    " << legacy.ticks << " ticks, " << legacy.uneven << " uneven frames";
+	if (legacy.uneven > 0) {
+		std::cout << ", the first after " << legacy.firstUneven / 3600.0 << " h";
+	}
+	std::cout << std::endl;
+	std::cout << (exact ? "frame timing exact" : "frame timing DRIFTED") << std::endl;
+	return exact ? 0 : 1;
+}
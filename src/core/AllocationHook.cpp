@@ -0,0 +1,74 @@
+// replaces the global operator new and delete to count every heap allocation per thread, see
+// core/Allocations.h, compiled straight into the executables that want it rather than into
+// capybara_core, so linking the library never swaps the allocator behind anyone's back
+
+// core
+#include "core/Allocations.h"
+
+// std
+#include <cstdlib>
+#include <new>
+
+namespace {
+	const bool registered = (Allocations::setTracking(), true);
+
+	void* allocate(std::size_t size) {
+		Allocations::recordAllocation(size);
+		return std::malloc(size ? size : 1);
+	}
+
+	void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+		Allocations::recordAllocation(size);
+		// aligned_alloc wants a multiple of the alignment
+		std::size_t align = (std::size_t)alignment;
+		return std::aligned_alloc(align, (size + align - 1) / align * align);
+	}
+
+	void release(void* pointer) {
+		if (pointer) {
+			Allocations::recordFree();
+			std::free(pointer);
+		}
+	}
+}
+
+void* operator new(std::size_t size) {
+	if (void* pointer = allocate(size)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	if (void* pointer = allocateAligned(size, alignment)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { release(pointer); }
@@ -0,0 +1,59 @@
+#include "core/Allocations.h"
+
+// std
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+	// constant initialized, so the hook can count allocations made before main and while threads start
+	thread_local Allocations::Counts threadCounts;
+	thread_local int scopeDepth = 0;
+	thread_local bool abortOnAllocation = false;
+
+	std::atomic<uint64_t> violations{0};
+	std::atomic<bool> tracking{false};
+}
+
+bool Allocations::isTracking() {
+	return tracking.load(std::memory_order_relaxed);
+}
+
+Allocations::Counts Allocations::getThreadCounts() {
+	return threadCounts;
+}
+
+uint64_t Allocations::getViolations() {
+	return violations.load(std::memory_order_relaxed);
+}
+
+void Allocations::recordAllocation(size_t bytes) {
+	++threadCounts.allocations;
+	threadCounts.bytes += bytes;
+	if (scopeDepth > 0) {
+		violations.fetch_add(1, std::memory_order_relaxed);
+		if (abortOnAllocation) {
+			// stdio straight to stderr, iostream could allocate while reporting
+			std::fprintf(stderr, "error allocating | %zu bytes | Heap allocation inside a NoAllocationScope.\n", bytes);
+			std::abort();
+		}
+	}
+}
+
+void Allocations::recordFree() {
+	++threadCounts.frees;
+}
+
+void Allocations::setTracking() {
+	tracking.store(true, std::memory_order_relaxed);
+}
+
+NoAllocationScope::NoAllocationScope(bool abortOnAllocation) : start(Allocations::getThreadCounts().allocations), previousAbort(::abortOnAllocation) {
+	++scopeDepth;
+	::abortOnAllocation = ::abortOnAllocation || abortOnAllocation;
+}
+
+NoAllocationScope::~NoAllocationScope() {
+	--scopeDepth;
+	::abortOnAllocation = previousAbort;
+}
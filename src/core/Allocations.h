@@ -0,0 +1,48 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+// heap allocations counted per thread by the global operator new and delete in core/AllocationHook.cpp,
+// only executables that compile that file in count anything (alloc_bench, or the app and capybara_sim
+// with ALLOCATION_TRACKING), elsewhere every count stays 0
+class Allocations {
+public:
+	struct Counts {
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t bytes = 0; // requested, not what the allocator rounded up to
+	};
+
+	// whether the hook is linked in
+	static bool isTracking();
+	// everything the calling thread allocated and freed so far
+	static Counts getThreadCounts();
+	// allocations inside a NoAllocationScope on any thread so far
+	static uint64_t getViolations();
+
+	// called by the hook, must not allocate
+	static void recordAllocation(size_t bytes);
+	static void recordFree();
+	static void setTracking();
+};
+
+// marks work that must not touch the heap, e.g. a frame after warm-up, any allocation on this
+// thread while it lives is a violation: counted, or with abortOnAllocation reported and aborted on,
+// so a debugger stops on the allocation's stack
+class NoAllocationScope {
+public:
+	explicit NoAllocationScope(bool abortOnAllocation = false);
+	~NoAllocationScope();
+
+	NoAllocationScope(const NoAllocationScope&) = delete;
+	NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+
+	// allocations on this thread since the scope began
+	uint64_t getAllocations() const { return Allocations::getThreadCounts().allocations - start; }
+
+private:
+	uint64_t start;
+	bool previousAbort;
+};
@@ -0,0 +1,92 @@
+#include "core/Behavior.h"
+
+// std
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+	constexpr const char* stateNames[numberOfAnimationStates] = {"Walk", "Run", "Idle", "Sit", "GetUp"};
+
+	bool parseState(const std::string& name, AnimationStates& state) {
+		for (int i = 0; i < numberOfAnimationStates; ++i) {
+			if (name == stateNames[i]) {
+				state = (AnimationStates)i;
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+void Behavior::sample(const uint32_t* pets, size_t count, const uint8_t* petStates, RandomStream* randoms, uint32_t* picked) const {
+	for (size_t i = 0; i < count; ++i) {
+		picked[i] = decide((AnimationStates)petStates[pets[i]], randoms[pets[i]]);
+	}
+}
+
+bool Behavior::load(const std::string& path) {
+	std::ifstream file(path);
+	if (!file) {
+		std::cout << "error reading | " << path << " | Maybe wrong file name." << std::endl;
+		return false;
+	}
+
+	std::vector<StateDescription> descriptions;
+	std::vector<TransitionDescription> transitions;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		++lineNumber;
+		std::istringstream words(line.substr(0, line.find('#')));
+		std::string name, verb;
+		if (!(words >> name)) {
+			continue;
+		}
+
+		AnimationStates state;
+		bool valid = parseState(name, state) && (words >> verb);
+		if (valid && verb == "moves") {
+			float speed = 0.0f;
+			valid = (bool)(words >> speed);
+			descriptions.push_back(moves(state, speed));
+		}
+		else if (valid && verb == "waits") {
+			float minDuration = 0.0f;
+			valid = (bool)(words >> minDuration);
+			float maxDuration = minDuration;
+			words >> maxDuration;
+			descriptions.push_back(waits(state, minDuration, maxDuration));
+		}
+		else if (valid && verb == "->") {
+			std::string toName, flag;
+			AnimationStates to = AnimationStates::Idle;
+			double weight = 0.0;
+			valid = (words >> toName) && parseState(toName, to) && (words >> weight);
+			bool newTarget = (bool)(words >> flag);
+			valid = valid && (!newTarget || flag == "target");
+			if (valid) {
+				transitions.push_back({state, to, weight, newTarget});
+			}
+		}
+		else {
+			valid = false;
+		}
+
+		// optional values that failed to read are left for this check
+		std::string rest;
+		words.clear();
+		if (!valid || words >> rest) {
+			std::cout << "error reading | " << path << " | Line " << lineNumber << " isn't a state or transition." << std::endl;
+			return false;
+		}
+	}
+
+	const char* error = compileBehavior(descriptions.data(), descriptions.size(), transitions.data(), transitions.size(), *this);
+	if (error) {
+		std::cout << "error reading | " << path << " | " << error << "." << std::endl;
+		return false;
+	}
+	return true;
+}
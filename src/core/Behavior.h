@@ -0,0 +1,210 @@
+#pragma once
+
+// core
+#include "core/Pet.h"
+#include "core/Random.h"
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// what a state does while it lasts, a state either walks to the pet's target and ends on arrival,
+// or waits for a duration drawn from [minDuration, maxDuration]
+struct StateDescription {
+	AnimationStates state;
+	float speed;       // world units per second, 0 for waiting states
+	float minDuration; // seconds
+	float maxDuration;
+};
+
+constexpr StateDescription moves(AnimationStates state, float speed) { return {state, speed, 0.0f, 0.0f}; }
+constexpr StateDescription waits(AnimationStates state, float duration) { return {state, 0.0f, duration, duration}; }
+constexpr StateDescription waits(AnimationStates state, float minDuration, float maxDuration) { return {state, 0.0f, minDuration, maxDuration}; }
+
+// when from ends, to follows with a chance proportional to weight among from's transitions
+struct TransitionDescription {
+	AnimationStates from;
+	AnimationStates to;
+	double weight;
+	bool newTarget; // picks a new spot to walk to before entering to
+};
+
+// a transition in the compiled table, a state's transitions form a Walker alias table: a draw picks
+// one of them uniformly, then keeps it below aliasThreshold and takes its alias above
+struct Transition {
+	float aliasThreshold;
+	uint8_t alias; // counted from the state's first transition
+	uint8_t nextState;
+	uint8_t newTarget;
+};
+
+struct StateBehavior {
+	float speed;
+	float minDuration;
+	float maxDuration;
+	uint8_t firstTransition; // into Behavior::transitions, a state's transitions are contiguous
+	uint8_t transitionCount;
+};
+
+constexpr size_t maxBehaviorTransitions = 32;
+
+// flat tables compiled from a behavior description, either at compile time with compileBehavior
+// or at run time with load, so new behaviors ship without recompiling
+struct Behavior {
+	StateBehavior states[numberOfAnimationStates] = {};
+	Transition transitions[maxBehaviorTransitions] = {};
+
+	constexpr bool isMoving(AnimationStates state) const { return states[state].speed > 0.0f; }
+
+	// picks what follows state in O(1) however many transitions it has, draws from the pet's stream
+	// only when there is a choice, returns the index into transitions
+	constexpr uint32_t decide(AnimationStates state, RandomStream& random) const {
+		const StateBehavior& behavior = states[state];
+		// the draw is computed either way and only taken when needed, the states come in no predictable order
+		uint64_t scaled = (random.peekBits() >> 40) * behavior.transitionCount;
+		random.counter += behavior.transitionCount > 1;
+
+		// the top bits of the 24 bit draw times the count pick the column, the rest is exact in a float
+		uint32_t column = (uint32_t)(scaled >> 24);
+		float fraction = (float)(int32_t)(scaled & 0xffffff) * (1.0f / 16777216.0f);
+		// selected with a mask, the compiler's branch mispredicts on about every other draw
+		const Transition& transition = transitions[behavior.firstTransition + column];
+		uint32_t keep = 0u - (uint32_t)(fraction < transition.aliasThreshold);
+		return behavior.firstTransition + (transition.alias ^ ((column ^ transition.alias) & keep));
+	}
+
+	// decide for every listed pet at once, e.g. all pets whose state ended this tick, writes each pick to picked
+	void sample(const uint32_t* pets, size_t count, const uint8_t* petStates, RandomStream* randoms, uint32_t* picked) const;
+
+	// seconds a waiting state lasts, draws only for a range
+	constexpr float drawDuration(AnimationStates state, RandomStream& random) const {
+		const StateBehavior& behavior = states[state];
+		float draw = toUnitFloat(random.peekBits());
+		random.counter += behavior.minDuration != behavior.maxDuration;
+		return behavior.minDuration + (behavior.maxDuration - behavior.minDuration) * draw;
+	}
+
+	// reads a description like res/behaviors/capybara.behavior, on errors prints them and returns false, leaving the behavior unchanged
+	bool load(const std::string& path);
+};
+
+// checks a description and flattens it into behavior, returns what is wrong with it or nullptr
+// every state needs exactly one description and at least one transition
+constexpr const char* compileBehavior(const StateDescription* descriptions, size_t descriptionCount,
+	const TransitionDescription* transitionDescriptions, size_t transitionCount, Behavior& behavior) {
+	Behavior compiled;
+	size_t count = 0;
+
+	for (int state = 0; state < numberOfAnimationStates; ++state) {
+		const StateDescription* description = nullptr;
+		for (size_t i = 0; i < descriptionCount; ++i) {
+			if (descriptions[i].state == state) {
+				if (description) {
+					return "A state is described twice";
+				}
+				description = &descriptions[i];
+			}
+		}
+		if (!description) {
+			return "A state is not described";
+		}
+		if (description->speed < 0.0f || (description->speed == 0.0f && !(description->minDuration > 0.0f && description->minDuration <= description->maxDuration))) {
+			return "A state needs a positive speed or a duration range";
+		}
+
+		double total = 0.0;
+		size_t first = count;
+		for (size_t i = 0; i < transitionCount; ++i) {
+			const TransitionDescription& transition = transitionDescriptions[i];
+			if (transition.from != state) {
+				continue;
+			}
+			if (!(transition.weight > 0.0)) {
+				return "A transition needs a positive weight";
+			}
+			if (count == maxBehaviorTransitions) {
+				return "Too many transitions";
+			}
+			total += transition.weight;
+			compiled.transitions[count++] = {1.0f, 0, (uint8_t)transition.to, (uint8_t)transition.newTarget};
+		}
+		if (count == first) {
+			return "A state has no transitions";
+		}
+		compiled.states[state] = {description->speed, description->minDuration, description->maxDuration, (uint8_t)first, (uint8_t)(count - first)};
+
+		// Vose's construction, every column is filled up to the average weight with the overflow of a heavier one
+		size_t n = count - first;
+		double scaled[maxBehaviorTransitions] = {};
+		size_t light[maxBehaviorTransitions] = {}, heavy[maxBehaviorTransitions] = {};
+		size_t lightCount = 0, heavyCount = 0;
+		for (size_t i = 0, j = 0; i < transitionCount; ++i) {
+			if (transitionDescriptions[i].from == state) {
+				scaled[j] = transitionDescriptions[i].weight * n / total;
+				(scaled[j] < 1.0 ? light[lightCount++] : heavy[heavyCount++]) = j;
+				++j;
+			}
+		}
+		while (lightCount > 0 && heavyCount > 0) {
+			size_t column = light[--lightCount];
+			size_t donor = heavy[--heavyCount];
+			compiled.transitions[first + column].aliasThreshold = (float)scaled[column];
+			compiled.transitions[first + column].alias = (uint8_t)donor;
+			scaled[donor] -= 1.0 - scaled[column];
+			(scaled[donor] < 1.0 ? light[lightCount++] : heavy[heavyCount++]) = donor;
+		}
+		// what is left is full up to rounding and keeps its own column
+		while (lightCount > 0) {
+			size_t column = light[--lightCount];
+			compiled.transitions[first + column].alias = (uint8_t)column;
+		}
+		while (heavyCount > 0) {
+			size_t column = heavy[--heavyCount];
+			compiled.transitions[first + column].alias = (uint8_t)column;
+		}
+	}
+
+	behavior = compiled;
+	return nullptr;
+}
+
+template <size_t descriptionCount, size_t transitionCount>
+constexpr Behavior compileBehavior(const StateDescription (&descriptions)[descriptionCount], const TransitionDescription (&transitions)[transitionCount]) {
+	Behavior behavior;
+	compileBehavior(descriptions, descriptionCount, transitions, transitionCount, behavior);
+	return behavior;
+}
+
+template <size_t descriptionCount, size_t transitionCount>
+constexpr bool isValidBehavior(const StateDescription (&descriptions)[descriptionCount], const TransitionDescription (&transitions)[transitionCount]) {
+	Behavior behavior;
+	return compileBehavior(descriptions, descriptionCount, transitions, transitionCount, behavior) == nullptr;
+}
+
+// the built in capybara, res/behaviors/capybara.behavior describes the same
+constexpr StateDescription capybaraStates[] = {
+	moves(Walk, 0.5f),
+	moves(Run, 1.0f),
+	waits(Idle, 3.0f, 6.0f),
+	waits(Sit, 3.0f),
+	waits(GetUp, 0.5f)
+};
+
+constexpr TransitionDescription capybaraTransitions[] = {
+	// from   to     weight  new target
+	{Idle,  Idle,  0.2,    true },
+	{Idle,  Walk,  0.4,    true },
+	{Idle,  Run,   0.2,    true },
+	{Idle,  Sit,   0.2,    true },
+	{Walk,  Idle,  0.5,    false},
+	{Walk,  Run,   0.2,    true },
+	{Walk,  Sit,   0.3,    false},
+	{Run,   Walk,  1.0,    true },
+	{Sit,   GetUp, 1.0,    false},
+	{GetUp, Idle,  1.0,    false}
+};
+
+static_assert(isValidBehavior(capybaraStates, capybaraTransitions), "the capybara behavior doesn't compile");
+
+constexpr Behavior capybaraBehavior = compileBehavior(capybaraStates, capybaraTransitions);
@@ -0,0 +1,22 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <cstdint>
+
+// monotonic time since construction in whole nanoseconds, differences between readings are exact
+// however long the app has been running and a uint64_t lasts centuries
+class Clock {
+public:
+	Clock() : start(std::chrono::steady_clock::now()) {}
+
+	uint64_t getNanoseconds() const {
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// for display and statistics only, step the world with nanosecond differences
+	double getSeconds() const { return getNanoseconds() * 1e-9; }
+
+private:
+	std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,119 @@
+#include "core/FrameArena.h"
+
+// std
+#include <algorithm>
+#include <new>
+
+namespace {
+	// the buffer starts on a cache line, so arrays of one thread never share a line with another's
+	constexpr size_t bufferAlignment = 64;
+
+	// growth is rounded to this, a frame a little over the last high water mark doesn't resize again
+	constexpr size_t growthGranularity = 64 * 1024;
+
+	// heads every heap block of a frame that didn't fit
+	struct OverflowHeader {
+		void* next;
+		void* block;
+		size_t alignment;
+	};
+
+	size_t alignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+FrameArena::FrameArena(size_t capacity)
+	: buffer(nullptr), capacity(0), offset(0), wanted(0), overflow(nullptr), overflowBytes(0), framePeak(0), highWater(0), overflowCount(0) {
+	reserve(capacity);
+}
+
+FrameArena::~FrameArena() {
+	freeOverflow(nullptr);
+	resize(0);
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+	// aligned by address, alignments past the buffer's own still hold
+	uintptr_t base = (uintptr_t)buffer;
+	size_t start = alignUp(base + offset, alignment) - base;
+	void* pointer;
+	if (buffer && start + bytes <= capacity) {
+		pointer = buffer + start;
+		offset = start + bytes;
+	}
+	else {
+		pointer = allocateOverflow(bytes, alignment);
+	}
+	framePeak = std::max(framePeak, getUsed());
+	highWater = std::max(highWater, framePeak);
+	return pointer;
+}
+
+void* FrameArena::allocateOverflow(size_t bytes, size_t alignment) {
+	alignment = std::max(alignment, alignof(OverflowHeader));
+	size_t headerSize = alignUp(sizeof(OverflowHeader), alignment);
+	void* block = ::operator new(headerSize + bytes, std::align_val_t(alignment));
+
+	// the header sits right before what is handed out
+	std::byte* pointer = static_cast<std::byte*>(block) + headerSize;
+	OverflowHeader* header = reinterpret_cast<OverflowHeader*>(pointer) - 1;
+	header->next = overflow;
+	header->block = block;
+	header->alignment = alignment;
+	overflow = pointer;
+	overflowBytes += headerSize + bytes;
+	++overflowCount;
+	return pointer;
+}
+
+void FrameArena::freeOverflow(void* until) {
+	while (overflow != until) {
+		OverflowHeader* header = static_cast<OverflowHeader*>(overflow) - 1;
+		overflow = header->next;
+		::operator delete(header->block, std::align_val_t(header->alignment));
+	}
+}
+
+void FrameArena::reset() {
+	freeOverflow(nullptr);
+	offset = 0;
+	overflowBytes = 0;
+
+	// the buffer is only replaced here, where nothing points into it
+	if (framePeak > capacity) {
+		wanted = std::max(wanted, alignUp(framePeak + framePeak / 2, growthGranularity));
+	}
+	if (wanted > capacity) {
+		resize(wanted);
+	}
+	framePeak = 0;
+}
+
+void FrameArena::reserve(size_t bytes) {
+	wanted = std::max(wanted, bytes);
+	if (getUsed() == 0 && wanted > capacity) {
+		resize(wanted);
+	}
+}
+
+void FrameArena::rewind(const Marker& marker) {
+	if (marker.offset == 0 && marker.overflow == nullptr) {
+		reset();
+		return;
+	}
+	freeOverflow(marker.overflow);
+	offset = marker.offset;
+	overflowBytes = marker.overflowBytes;
+}
+
+void FrameArena::resize(size_t bytes) {
+	if (buffer) {
+		::operator delete(buffer, std::align_val_t(bufferAlignment));
+		buffer = nullptr;
+	}
+	capacity = bytes;
+	if (bytes > 0) {
+		buffer = static_cast<std::byte*>(::operator new(bytes, std::align_val_t(bufferAlignment)));
+	}
+}
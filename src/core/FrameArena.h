@@ -0,0 +1,88 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+
+// scratch memory for one frame, allocating bumps an offset into one buffer and freeing does nothing,
+// everything goes at once when the main loop resets the arena, so lists rebuilt every frame cost
+// no heap calls and no locks however many threads allocate elsewhere
+// a frame that doesn't fit takes the rest from the heap, and the next reset grows the buffer past
+// that frame's high water mark, so once warmed up a frame never touches the heap
+// one per thread, nothing in it is synchronized, and a std::pmr::memory_resource so pmr containers
+// can live in it too
+class FrameArena : public std::pmr::memory_resource {
+public:
+	// where the arena stood, rewinding to it frees everything allocated since
+	struct Marker {
+		size_t offset;
+		void* overflow;
+		size_t overflowBytes;
+	};
+
+	// rewinds when it ends, for scratch only needed by part of a frame, e.g. one of several ticks
+	class Scope {
+	public:
+		explicit Scope(FrameArena& arena) : arena(arena), marker(arena.getMarker()) {}
+		~Scope() { arena.rewind(marker); }
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		FrameArena& arena;
+		Marker marker;
+	};
+
+	explicit FrameArena(size_t capacity = 0);
+	~FrameArena() override;
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// count uninitialized elements, valid until the arena is reset or rewound past them
+	template <typename T>
+	std::span<T> allocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>, "a reset runs no destructors");
+		return {static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count};
+	}
+
+	// frees everything, grows the buffer if the frame didn't fit, done at the top of the main loop
+	void reset();
+	// a buffer of at least bytes from the next reset on, at once while nothing is allocated
+	void reserve(size_t bytes);
+
+	Marker getMarker() const { return {offset, overflow, overflowBytes}; }
+	// rewinding to an empty arena is a reset
+	void rewind(const Marker& marker);
+
+	// bytes allocated since the last reset, padding and what went to the heap included
+	size_t getUsed() const { return offset + overflowBytes; }
+	size_t getCapacity() const { return capacity; }
+	// most bytes any frame used at once
+	size_t getHighWater() const { return highWater; }
+	// allocations that didn't fit and went to the heap, over the arena's lifetime
+	uint64_t getOverflowCount() const { return overflowCount; }
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void*, size_t, size_t) override {}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	void* allocateOverflow(size_t bytes, size_t alignment);
+	void freeOverflow(void* until);
+	void resize(size_t bytes);
+
+	std::byte* buffer;
+	size_t capacity;
+	size_t offset;
+	size_t wanted;    // capacity the next reset grows to
+	void* overflow;   // this frame's heap blocks, newest first, linked through their headers
+	size_t overflowBytes;
+	size_t framePeak; // most bytes used at once since the last reset
+	size_t highWater;
+	uint64_t overflowCount;
+};
@@ -0,0 +1,124 @@
+#include "core/JobSystem.h"
+
+// std
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned threads) {
+	if (threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	for (unsigned i = 0; i < threads; ++i) {
+		queues.push_back(std::make_unique<Queue>());
+	}
+	// thread 0 is whoever calls parallelFor
+	for (unsigned i = 1; i < threads; ++i) {
+		workers.emplace_back(&JobSystem::workerLoop, this, i);
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+// a thread's share of the chunks rounds up to one more than the even split
+void JobSystem::reserve(size_t chunkCount) {
+	for (std::unique_ptr<Queue>& queue : queues) {
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->chunks.reserve(chunkCount / queues.size() + 1);
+	}
+}
+
+void JobSystem::parallelFor(size_t count, size_t chunkSize, ChunkBody body) {
+	if (count == 0) {
+		return;
+	}
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	if (queues.size() == 1 || chunkCount == 1) {
+		for (size_t begin = 0; begin < count; begin += chunkSize) {
+			body(begin, std::min(begin + chunkSize, count));
+		}
+		return;
+	}
+
+	// every thread starts on a contiguous run of chunks so neighbouring pets stay on one core
+	this->body = &body;
+	pending.store(chunkCount, std::memory_order_relaxed);
+	size_t threads = queues.size();
+	for (size_t thread = 0; thread < threads; ++thread) {
+		std::lock_guard<std::mutex> lock(queues[thread]->mutex);
+		queues[thread]->chunks.clear();
+		queues[thread]->first = 0;
+		for (size_t chunk = chunkCount * thread / threads; chunk < chunkCount * (thread + 1) / threads; ++chunk) {
+			queues[thread]->chunks.push_back({chunk * chunkSize, std::min((chunk + 1) * chunkSize, count)});
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		++generation;
+	}
+	wake.notify_all();
+
+	work(0);
+	// the last chunks may still be running on other threads
+	while (pending.load(std::memory_order_acquire) != 0) {
+		std::this_thread::yield();
+	}
+	this->body = nullptr;
+}
+
+void JobSystem::workerLoop(unsigned thread) {
+	uint64_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wake.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+		work(thread);
+	}
+}
+
+void JobSystem::work(unsigned thread) {
+	Chunk chunk;
+	while (pop(thread, chunk) || steal(thread, chunk)) {
+		(*body)(chunk.begin, chunk.end);
+		pending.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+bool JobSystem::pop(unsigned thread, Chunk& chunk) {
+	Queue& queue = *queues[thread];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.chunks.size() == queue.first) {
+		return false;
+	}
+	chunk = queue.chunks.back();
+	queue.chunks.pop_back();
+	return true;
+}
+
+// victims are tried in order starting after the thief, taking the chunk furthest from their own work
+bool JobSystem::steal(unsigned thread, Chunk& chunk) {
+	size_t threads = queues.size();
+	for (size_t offset = 1; offset < threads; ++offset) {
+		Queue& queue = *queues[(thread + offset) % threads];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.chunks.size() > queue.first) {
+			chunk = queue.chunks[queue.first++];
+			steals.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
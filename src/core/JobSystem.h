@@ -0,0 +1,88 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// a loop body borrowed for the length of a call, unlike std::function it never copies a lambda
+// onto the heap, so running a loop doesn't allocate
+class ChunkBody {
+public:
+	template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, ChunkBody>>>
+	ChunkBody(Function&& function)
+		: callable((void*)std::addressof(function)),
+		invoke([](void* callable, size_t begin, size_t end) { (*(std::remove_reference_t<Function>*)callable)(begin, end); }) {}
+
+	void operator()(size_t begin, size_t end) const { invoke(callable, begin, end); }
+
+private:
+	void* callable;
+	void (*invoke)(void*, size_t, size_t);
+};
+
+// work stealing thread pool for data parallel loops over the population
+// each thread owns a queue of chunks, pops its own from the back and steals from the front of
+// the others when it runs dry, so uneven chunks still keep every thread busy
+// the calling thread works too, a JobSystem of 1 thread runs everything inline
+class JobSystem {
+public:
+	// threads counts the caller, 0 picks one per hardware thread
+	explicit JobSystem(unsigned threads = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// runs body(begin, end) over [0, count) in chunks of at most chunkSize and returns once all ran
+	// chunk bounds only depend on count and chunkSize, never on the thread count, so a body
+	// writing per chunk results gives the same output however many threads there are
+	void parallelFor(size_t count, size_t chunkSize, ChunkBody body);
+
+	// room for loops of up to this many chunks, running one never allocates, otherwise the queues
+	// grow the first time a loop has more chunks than any before it
+	void reserve(size_t chunkCount);
+
+	unsigned getThreadCount() const { return (unsigned)queues.size(); }
+
+	// chunks run by a thread other than the one they were queued on, since construction
+	uint64_t getSteals() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+	struct Chunk {
+		size_t begin, end;
+	};
+
+	// chunks are only ever added to an empty queue, so a vector with a moving front keeps its capacity from loop to loop
+	struct Queue {
+		std::mutex mutex;
+		std::vector<Chunk> chunks;
+		size_t first = 0; // stolen from the front up to here
+	};
+
+	void workerLoop(unsigned thread);
+	// runs chunks until none are left to pop or steal
+	void work(unsigned thread);
+	bool pop(unsigned thread, Chunk& chunk);
+	bool steal(unsigned thread, Chunk& chunk);
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+
+	// the loop being run, set before its chunks are queued
+	const ChunkBody* body = nullptr;
+	std::atomic<size_t> pending{0}; // chunks not finished yet
+	std::atomic<uint64_t> steals{0};
+
+	// workers sleep between loops, a new generation wakes them
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	uint64_t generation = 0;
+	bool stopping = false;
+};
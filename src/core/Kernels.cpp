@@ -0,0 +1,162 @@
+#include "core/Kernels.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define KERNELS_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KERNELS_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define KERNELS_NEON
+#endif
+
+namespace {
+	// appends the set lanes of a comparison bitmask as pet indices
+	inline size_t appendMask(unsigned mask, size_t base, uint32_t* out, size_t count) {
+		while (mask) {
+			out[count++] = (uint32_t)(base + __builtin_ctz(mask));
+			mask &= mask - 1;
+		}
+		return count;
+	}
+
+#if defined(KERNELS_NEON)
+	inline unsigned movemask(uint32x4_t mask) {
+		static const uint32_t bits[4] = {1, 2, 4, 8};
+		return vaddvq_u32(vandq_u32(mask, vld1q_u32(bits)));
+	}
+#endif
+}
+
+const char* getKernelInstructionSet() {
+#if defined(KERNELS_AVX)
+	return "AVX";
+#elif defined(KERNELS_SSE)
+	return "SSE2";
+#elif defined(KERNELS_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+void integratePositions(float* x, float* y, const float* vx, const float* vy, size_t count, float dt) {
+	size_t i = 0;
+
+#if defined(KERNELS_AVX)
+	__m256 step = _mm256_set1_ps(dt);
+	for (; i + 8 <= count; i += 8) {
+		_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), step)));
+		_mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), step)));
+	}
+#elif defined(KERNELS_SSE)
+	__m128 step = _mm_set1_ps(dt);
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), step)));
+		_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), step)));
+	}
+#elif defined(KERNELS_NEON)
+	float32x4_t step = vdupq_n_f32(dt);
+	for (; i + 4 <= count; i += 4) {
+		vst1q_f32(x + i, vmlaq_f32(vld1q_f32(x + i), vld1q_f32(vx + i), step));
+		vst1q_f32(y + i, vmlaq_f32(vld1q_f32(y + i), vld1q_f32(vy + i), step));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		movePet(x[i], y[i], vx[i], vy[i], dt);
+	}
+}
+
+size_t findArrivals(const float* x, const float* y, const float* tx, const float* ty, const float* vx, const float* vy, size_t count, float radius, uint32_t* arrived) {
+	float radiusSquared = radius * radius;
+	size_t found = 0;
+	size_t i = 0;
+
+#if defined(KERNELS_AVX)
+	__m256 limit = _mm256_set1_ps(radiusSquared);
+	__m256 zero = _mm256_setzero_ps();
+	for (; i + 8 <= count; i += 8) {
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(tx + i), _mm256_loadu_ps(x + i));
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ty + i), _mm256_loadu_ps(y + i));
+		__m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		__m256 vx8 = _mm256_loadu_ps(vx + i);
+		__m256 vy8 = _mm256_loadu_ps(vy + i);
+		__m256 speed = _mm256_add_ps(_mm256_mul_ps(vx8, vx8), _mm256_mul_ps(vy8, vy8));
+		__m256 ahead = _mm256_add_ps(_mm256_mul_ps(dx, vx8), _mm256_mul_ps(dy, vy8));
+		__m256 reached = _mm256_or_ps(_mm256_cmp_ps(distance, limit, _CMP_LT_OQ), _mm256_cmp_ps(ahead, zero, _CMP_LE_OQ));
+		__m256 hit = _mm256_and_ps(reached, _mm256_cmp_ps(speed, zero, _CMP_GT_OQ));
+		found = appendMask((unsigned)_mm256_movemask_ps(hit), i, arrived, found);
+	}
+#elif defined(KERNELS_SSE)
+	__m128 limit = _mm_set1_ps(radiusSquared);
+	__m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(tx + i), _mm_loadu_ps(x + i));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(ty + i), _mm_loadu_ps(y + i));
+		__m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		__m128 vx4 = _mm_loadu_ps(vx + i);
+		__m128 vy4 = _mm_loadu_ps(vy + i);
+		__m128 speed = _mm_add_ps(_mm_mul_ps(vx4, vx4), _mm_mul_ps(vy4, vy4));
+		__m128 ahead = _mm_add_ps(_mm_mul_ps(dx, vx4), _mm_mul_ps(dy, vy4));
+		__m128 reached = _mm_or_ps(_mm_cmplt_ps(distance, limit), _mm_cmple_ps(ahead, zero));
+		__m128 hit = _mm_and_ps(reached, _mm_cmpgt_ps(speed, zero));
+		found = appendMask((unsigned)_mm_movemask_ps(hit), i, arrived, found);
+	}
+#elif defined(KERNELS_NEON)
+	float32x4_t limit = vdupq_n_f32(radiusSquared);
+	float32x4_t zero = vdupq_n_f32(0.0f);
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t dx = vsubq_f32(vld1q_f32(tx + i), vld1q_f32(x + i));
+		float32x4_t dy = vsubq_f32(vld1q_f32(ty + i), vld1q_f32(y + i));
+		float32x4_t distance = vmlaq_f32(vmulq_f32(dx, dx), dy, dy);
+		float32x4_t vx4 = vld1q_f32(vx + i);
+		float32x4_t vy4 = vld1q_f32(vy + i);
+		float32x4_t speed = vmlaq_f32(vmulq_f32(vx4, vx4), vy4, vy4);
+		float32x4_t ahead = vmlaq_f32(vmulq_f32(dx, vx4), dy, vy4);
+		uint32x4_t reached = vorrq_u32(vcltq_f32(distance, limit), vcleq_f32(ahead, zero));
+		uint32x4_t hit = vandq_u32(reached, vcgtq_f32(speed, zero));
+		found = appendMask(movemask(hit), i, arrived, found);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		float speed = vx[i] * vx[i] + vy[i] * vy[i];
+		if (hasArrived(x[i], y[i], tx[i], ty[i], vx[i], vy[i], radiusSquared) && speed > 0.0f) {
+			arrived[found++] = (uint32_t)i;
+		}
+	}
+	return found;
+}
+
+// positions scatter over the arrays, gathers don't pay off below AVX2 so this stays scalar, the rest
+// is packed in list order and read straight through, and the positions of the pets a few places
+// ahead are fetched while this one moves, so their misses overlap instead of each stalling in turn
+size_t moveListed(float* x, float* y, float* previousX, float* previousY, const float* tx, const float* ty, const float* vx, const float* vy,
+	const uint32_t* listed, size_t count, float dt, float radius, uint32_t* arrived) {
+	constexpr size_t prefetchDistance = 16;
+	float radiusSquared = radius * radius;
+	size_t found = 0;
+	for (size_t n = 0; n < count; ++n) {
+		if (n + prefetchDistance < count) {
+			uint32_t ahead = listed[n + prefetchDistance];
+			__builtin_prefetch(x + ahead, 1);
+			__builtin_prefetch(y + ahead, 1);
+			__builtin_prefetch(previousX + ahead, 1);
+			__builtin_prefetch(previousY + ahead, 1);
+		}
+		uint32_t i = listed[n];
+		float px = x[i];
+		float py = y[i];
+		previousX[i] = px;
+		previousY[i] = py;
+		movePet(px, py, vx[n], vy[n], dt);
+		x[i] = px;
+		y[i] = py;
+		if (hasArrived(px, py, tx[n], ty[n], vx[n], vy[n], radiusSquared)) {
+			arrived[found++] = i;
+		}
+	}
+	return found;
+}
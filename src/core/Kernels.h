@@ -0,0 +1,36 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+// batch kernels over Population arrays, AVX, SSE2 or NEON depending on the target with a scalar tail
+
+// name of the instruction set the kernels were compiled for
+const char* getKernelInstructionSet();
+
+// one pet's move over one step, what every kernel lane does, World::advance repeats it to land on
+// exactly the floats stepping does
+inline void movePet(float& x, float& y, float vx, float vy, float dt) {
+	x += vx * dt;
+	y += vy * dt;
+}
+
+// closer than the radius to its target, or already past it
+inline bool hasArrived(float x, float y, float tx, float ty, float vx, float vy, float radiusSquared) {
+	float dx = tx - x;
+	float dy = ty - y;
+	return dx * dx + dy * dy < radiusSquared || dx * vx + dy * vy <= 0.0f;
+}
+
+// x += vx * dt and y += vy * dt for every pet
+void integratePositions(float* x, float* y, const float* vx, const float* vy, size_t count, float dt);
+
+// moves only the listed pets, keeping where they were in previousX and previousY, and writes each of them that is
+// now closer than radius to its target, or past it, to arrived, returns how many, targets and velocities are
+// packed in list order, tx[n] is listed[n]'s
+size_t moveListed(float* x, float* y, float* previousX, float* previousY, const float* tx, const float* ty, const float* vx, const float* vy,
+	const uint32_t* listed, size_t count, float dt, float radius, uint32_t* arrived);
+
+// writes the index of every moving pet closer than radius to its target, or already past it, to arrived, returns how many
+size_t findArrivals(const float* x, const float* y, const float* tx, const float* ty, const float* vx, const float* vy, size_t count, float radius, uint32_t* arrived);
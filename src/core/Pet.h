@@ -0,0 +1,91 @@
+#pragma once
+
+// core
+#include "core/Random.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// glm
+#include <glm/glm.hpp>
+
+enum AnimationStates {
+	Walk,
+	Run,
+	Idle,
+	Sit,
+	GetUp
+};
+
+constexpr int numberOfAnimationStates = 5;
+
+enum SpriteSheets {
+	WalkSheet,
+	RunSheet,
+	IdleSheet,
+	SitSheet
+};
+
+constexpr int numberOfSpriteSheets = 4;
+
+// how a state plays its sprite sheet, GetUp plays the sit sheet backwards
+struct Animation {
+	SpriteSheets sheet;
+	int numberOfFrames;
+	float frameDuration;
+	bool looping;
+	bool reversed;
+};
+
+constexpr Animation animations[numberOfAnimationStates] = {
+	{WalkSheet, 5, 0.15f, true,  false}, // Walk
+	{RunSheet,  5, 0.1f,  true,  false}, // Run
+	{IdleSheet, 5, 0.2f,  true,  false}, // Idle
+	{SitSheet,  5, 0.1f,  false, false}, // Sit
+	{SitSheet,  5, 0.1f,  false, true }  // GetUp
+};
+
+constexpr const Animation& getAnimation(AnimationStates state) {
+	return animations[state];
+}
+
+// frame of the sheet on screen secondsInState after the state was entered, matches the vertex shader
+inline int getAnimationFrame(const Animation& animation, double secondsInState) {
+	double played = std::max(std::floor(secondsInState / animation.frameDuration), 0.0);
+	int first = animation.reversed ? animation.numberOfFrames - 1 : 0;
+	int step = animation.reversed ? -1 : 1;
+	if (animation.looping) {
+		int wrapped = (int)std::fmod(played, (double)animation.numberOfFrames);
+		return (first + step * wrapped + animation.numberOfFrames) % animation.numberOfFrames;
+	}
+	double frame = first + step * std::min(played, (double)animation.numberOfFrames);
+	return (int)std::clamp(frame, 0.0, (double)(animation.numberOfFrames - 1));
+}
+
+// names a pet for as long as it lives, its index changes whenever another pet is despawned
+// slots are reused once their pet is gone, each time with a new generation, so old handles stay dead
+struct PetHandle {
+	uint32_t slot = ~0u;
+	uint32_t generation = 0; // never 0 for a pet that was spawned
+
+	bool isNull() const { return generation == 0; }
+	bool operator==(const PetHandle& other) const = default;
+};
+
+// everything the simulation knows about a single capybara, no rendering state
+struct Pet {
+	glm::vec2 position;
+	glm::vec2 scale;
+	glm::vec2 targetPosition;
+
+	AnimationStates state;
+	uint64_t stateEndTick;   // tick the state times out on, 0 while walking or running
+	uint64_t stateStartTick; // tick the current state was entered on, animations play from here
+
+	int frameIndex; // frame of the sheet on screen, derived from the start tick
+	bool flipped;
+
+	RandomStream random; // every random decision the pet makes comes from its own stream
+};
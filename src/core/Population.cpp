@@ -0,0 +1,50 @@
+#include "core/Population.h"
+
+size_t Population::add() {
+	positionX.push_back(0.0f);
+	positionY.push_back(0.0f);
+	previousX.push_back(0.0f);
+	previousY.push_back(0.0f);
+	targetX.push_back(0.0f);
+	targetY.push_back(0.0f);
+	velocityX.push_back(0.0f);
+	velocityY.push_back(0.0f);
+	scaleX.push_back(1.0f);
+	scaleY.push_back(1.0f);
+
+	stateEndTick.push_back(0);
+	stateStartTick.push_back(0);
+
+	state.push_back(AnimationStates::Idle);
+	flipped.push_back(0);
+	leader.push_back(PetHandle());
+	slot.push_back(0);
+
+	random.push_back(RandomStream());
+	return size() - 1;
+}
+
+void Population::remove(size_t index) {
+	forEachField([index](auto& values) {
+		values[index] = values.back();
+		values.pop_back();
+	});
+}
+
+void Population::reserve(size_t capacity) {
+	forEachField([capacity](auto& values) { values.reserve(capacity); });
+}
+
+Pet Population::getPet(size_t index) const {
+	Pet pet;
+	pet.position = glm::vec2(positionX[index], positionY[index]);
+	pet.scale = glm::vec2(scaleX[index], scaleY[index]);
+	pet.targetPosition = glm::vec2(targetX[index], targetY[index]);
+	pet.state = (AnimationStates)state[index];
+	pet.stateEndTick = stateEndTick[index];
+	pet.stateStartTick = stateStartTick[index];
+	pet.frameIndex = 0;
+	pet.flipped = flipped[index] != 0;
+	pet.random = random[index];
+	return pet;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// core
+#include "core/Pet.h"
+
+// std
+#include <cstdint>
+#include <vector>
+
+// every pet field in its own contiguous array so per tick kernels stream through memory
+struct Population {
+	std::vector<float> positionX, positionY;
+	std::vector<float> previousX, previousY; // positions before the last tick, drawing blends from them
+	std::vector<float> targetX, targetY;
+	std::vector<float> velocityX, velocityY;
+	std::vector<float> scaleX, scaleY;
+
+	// whole ticks so timers expire on exactly the tick they were set for, however long the app runs
+	std::vector<uint64_t> stateEndTick; // 0 while walking or running, those end on arrival
+	std::vector<uint64_t> stateStartTick;
+
+	std::vector<uint8_t> state;
+	std::vector<uint8_t> flipped;
+
+	std::vector<PetHandle> leader; // the pet this one walks behind, null when it walks to its own target
+	std::vector<uint32_t> slot;    // the pet's handle slot, see World::getHandle
+
+	std::vector<RandomStream> random;
+
+	size_t size() const { return state.size(); }
+	// pets that fit before adding reallocates
+	size_t capacity() const { return state.capacity(); }
+
+	// appends a zeroed pet and returns its index
+	size_t add();
+	// moves the last pet into index and drops the last place, O(1) but the last pet's index changes
+	void remove(size_t index);
+	// room for this many pets, adding up to it never reallocates
+	void reserve(size_t capacity);
+
+	// gathers one pet back into a struct for inspection, the frame is left for World::getPet
+	Pet getPet(size_t index) const;
+
+private:
+	// calls field(array) for every array above, so removing and reserving can't miss one
+	template <typename Field>
+	void forEachField(Field&& field) {
+		field(positionX); field(positionY);
+		field(previousX); field(previousY);
+		field(targetX); field(targetY);
+		field(velocityX); field(velocityY);
+		field(scaleX); field(scaleY);
+		field(stateEndTick); field(stateStartTick);
+		field(state); field(flipped);
+		field(leader); field(slot);
+		field(random);
+	}
+};
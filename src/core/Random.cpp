@@ -0,0 +1,17 @@
+#include "core/Random.h"
+
+// plain loops over independent streams, no branches so the compiler can vectorize them
+void fillUniforms(RandomStream* streams, float* out, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = toUnitFloat(mixBits(streams[i].key + streams[i].counter * goldenGamma));
+		streams[i].counter += 1;
+	}
+}
+
+void fillUniforms(RandomStream* streams, float* out, size_t count, float lower, float upper) {
+	float range = upper - lower;
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = lower + range * toUnitFloat(mixBits(streams[i].key + streams[i].counter * goldenGamma));
+		streams[i].counter += 1;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint64_t goldenGamma = 0x9e3779b97f4a7c15ull;
+
+// SplitMix64 finalizer, turns consecutive counters into well mixed bits
+constexpr uint64_t mixBits(uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+
+// top 24 bits as a float in [0, 1), converting through int32 avoids the slow uint64 to float path
+constexpr float toUnitFloat(uint64_t bits) {
+	return (float)(int32_t)(bits >> 40) * (1.0f / 16777216.0f);
+}
+
+// counter based generator, draw n of a stream is mixBits(key + n * goldenGamma)
+// so it is 16 bytes of state, cheap to seed and any draw can be recomputed from (key, n)
+struct RandomStream {
+	uint64_t key;
+	uint64_t counter;
+
+	constexpr RandomStream() : key(0), counter(0) {}
+	constexpr RandomStream(uint64_t seed, uint64_t stream) : key(mixBits(seed ^ mixBits(stream * goldenGamma + goldenGamma))), counter(0) {}
+
+	constexpr uint64_t nextBits() { return mixBits(key + (counter++) * goldenGamma); }
+	// the draw nextBits would return, without taking it
+	constexpr uint64_t peekBits() const { return mixBits(key + counter * goldenGamma); }
+	constexpr float nextFloat() { return toUnitFloat(nextBits()); }
+	constexpr float nextFloat(float lower, float upper) { return lower + (upper - lower) * nextFloat(); }
+	constexpr bool nextBool() { return (nextBits() >> 63) != 0; }
+};
+
+// writes the next uniform in [0, 1) of every stream to out and advances each stream once
+void fillUniforms(RandomStream* streams, float* out, size_t count);
+
+// same as above but scaled to [lower, upper)
+void fillUniforms(RandomStream* streams, float* out, size_t count, float lower, float upper);
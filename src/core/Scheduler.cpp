@@ -0,0 +1,40 @@
+#include "core/Scheduler.h"
+
+// std
+#include <algorithm>
+#include <ctime>
+
+namespace {
+	// CPU time of the whole process, every thread included
+	double getProcessCPUTime() {
+		return (double)std::clock() / CLOCKS_PER_SEC;
+	}
+}
+
+FrameScheduler::FrameScheduler(double maxWait) : maxWait(maxWait), windowStart(-1.0), windowCPUStart(0.0), windowWakeups(0) {}
+
+double FrameScheduler::getWaitTime(const World& world) const {
+	return std::min(world.getTimeUntilTick(world.getNextEventTick()), maxWait);
+}
+
+bool FrameScheduler::wokeUp(double now) {
+	if (windowStart < 0.0) {
+		windowStart = now;
+		windowCPUStart = getProcessCPUTime();
+	}
+	++windowWakeups;
+
+	double elapsed = now - windowStart;
+	if (elapsed < 1.0) {
+		return false;
+	}
+
+	double cpuTime = getProcessCPUTime();
+	stats.wakeupsPerSecond = windowWakeups / elapsed;
+	stats.cpuPercent = (cpuTime - windowCPUStart) / elapsed * 100.0;
+
+	windowStart = now;
+	windowCPUStart = cpuTime;
+	windowWakeups = 0;
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// core
+#include "core/World.h"
+
+struct SchedulerStats {
+	double wakeupsPerSecond = 0.0;
+	double cpuPercent = 0.0; // process CPU time over wall time, 100 is one core busy
+};
+
+// decides how long the loop may block before the world has something new to show, and measures
+// how often it actually wakes up and what that costs, so idle power draw can be checked
+class FrameScheduler {
+public:
+	// waits are capped so window state like the desktop setting is still picked up
+	explicit FrameScheduler(double maxWait = 1.0);
+
+	// seconds until the next pet moves, flips an animation frame or changes state, 0 when one is due
+	double getWaitTime(const World& world) const;
+
+	// counts one wake up at wall time now, returns true once a second when new stats are ready
+	bool wokeUp(double now);
+
+	const SchedulerStats& getStats() const { return stats; }
+
+private:
+	double maxWait;
+
+	// the window the current stats are being counted over
+	double windowStart;
+	double windowCPUStart;
+	int windowWakeups;
+
+	SchedulerStats stats;
+};
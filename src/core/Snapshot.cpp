@@ -0,0 +1,47 @@
+#include "core/Snapshot.h"
+
+// std
+#include <limits>
+
+void WorldSnapshot::capture(const World& world) {
+	const Population& population = world.getPopulation();
+	// a world with a capacity never grows past it, neither does the snapshot
+	if (world.getCapacity() > pets.capacity()) {
+		reserve(world.getCapacity());
+	}
+	tickCount = world.getTickCount();
+	timestep = world.getSettings().timestep;
+	blend = world.getBlend();
+	blending = world.isBlending();
+
+	// the world keeps each field in its own array for the kernels stepping it, drawing wants each pet in one place
+	pets.resize(population.size());
+	// each record is put together in registers and stored whole
+	uint32_t maxAge = std::numeric_limits<uint32_t>::max();
+	for (size_t i = 0; i < pets.size(); ++i) {
+		PetRecord pet;
+		pet.positionX = population.positionX[i];
+		pet.positionY = population.positionY[i];
+		pet.previousX = population.previousX[i];
+		pet.previousY = population.previousY[i];
+		pet.scaleX = PetRecord::packScale(population.scaleX[i]);
+		pet.scaleY = PetRecord::packScale(population.scaleY[i]);
+		pet.stateAge = (uint32_t)std::min<uint64_t>(tickCount - population.stateStartTick[i], maxAge);
+		pet.slot = population.slot[i];
+		// about half the pets move, bitwise ors instead of branches that would mispredict on every other one
+		uint32_t moving = (uint32_t)(population.velocityX[i] != 0.0f) | (uint32_t)(population.velocityY[i] != 0.0f);
+		uint32_t flipped = (uint32_t)(population.flipped[i] != 0);
+		pet.flags = population.state[i] | (flipped * PetRecord::flippedFlag) | (moving * PetRecord::movingFlag);
+		pets[i] = pet;
+	}
+}
+
+RenderView::RenderView(const WorldSnapshot& snapshot) : RenderView(snapshot, snapshot.blend) {}
+
+RenderView::RenderView(const WorldSnapshot& snapshot, float blend)
+	: pets(snapshot.pets.data()), count(snapshot.size()), tickCount(snapshot.tickCount), timestep(snapshot.timestep), blend(blend) {}
+
+int RenderView::getFrameIndex(size_t index) const {
+	double stateTime = ((double)pets[index].stateAge + 0.5) * timestep;
+	return getAnimationFrame(getAnimation(getState(index)), stateTime);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+// core
+#include "core/World.h"
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// one pet as drawing sees it, packed so reading a pet touches half a cache line instead of a dozen
+// arrays, what its animation looks like is shared by every pet in its state, see getAnimation
+// positions stay floats, half floats would land most of a pixel off near the window's edges
+struct PetRecord {
+	float positionX, positionY;
+	float previousX, previousY;
+	int16_t scaleX, scaleY; // fixed point with scaleBits fraction bits, 0.5 is exact
+	uint32_t stateAge;      // ticks since the state was entered, saturates after 2^32
+	uint32_t slot;          // which pet this is, a despawn moves another one into its index
+	uint32_t flags;         // state in the low bits, then flipped and moving, packed by hand since
+	                        // bitfield stores each read back the whole word and capturing slows 2x
+
+	static constexpr uint32_t stateMask = 0x7;
+	static constexpr uint32_t flippedFlag = 1u << 3;
+	static constexpr uint32_t movingFlag = 1u << 4; // walking or running, drawing never needs the velocity itself
+
+	static constexpr int scaleBits = 12;
+	static constexpr float scaleUnit = 1.0f / (1 << scaleBits);
+
+	// rounds to the nearest step, clamped to what fits, biased positive so truncating rounds without a libm call
+	static int16_t packScale(float scale) {
+		float steps = std::clamp(scale * (1 << scaleBits), (float)INT16_MIN, (float)INT16_MAX);
+		return (int16_t)((int32_t)(steps + 32768.5f) - 32768);
+	}
+};
+static_assert(sizeof(PetRecord) == 32, "two pets per cache line");
+static_assert(numberOfAnimationStates <= PetRecord::stateMask + 1, "states have 3 bits");
+
+// what drawing needs of every pet at one tick, copied out of the world so another thread can draw
+// it while the simulation moves on, capturing again reuses the array
+struct WorldSnapshot {
+	std::vector<PetRecord> pets;
+
+	uint64_t tickCount = 0;
+	double timestep = 1.0 / 60.0;
+	float blend = 0.0f;     // World::getBlend when captured
+	bool blending = false;  // World::isBlending when captured
+
+	void capture(const World& world);
+	void reserve(size_t capacity) { pets.reserve(capacity); }
+	size_t size() const { return pets.size(); }
+};
+
+// the pets of a snapshot as the renderer reads them, borrowed rather than copied
+struct RenderView {
+	RenderView(const WorldSnapshot& snapshot);
+	// blended further than when captured, e.g. by the time since on a thread drawing at the display's rate
+	RenderView(const WorldSnapshot& snapshot, float blend);
+
+	size_t size() const { return count; }
+	uint64_t getTickCount() const { return tickCount; }
+	double getTimestep() const { return timestep; }
+	double getTime() const { return tickCount * timestep; }
+	float getBlend() const { return blend; }
+	// where the pet is drawn, blend of the way from its previous position to its current one
+	glm::vec2 getPosition(size_t index) const {
+		const PetRecord& pet = pets[index];
+		return glm::vec2(pet.previousX + (pet.positionX - pet.previousX) * blend, pet.previousY + (pet.positionY - pet.previousY) * blend);
+	}
+	// moving or still blending into where it stopped
+	bool isMoving(size_t index) const {
+		const PetRecord& pet = pets[index];
+		return (pet.flags & PetRecord::movingFlag) || pet.previousX != pet.positionX || pet.previousY != pet.positionY;
+	}
+	glm::vec2 getScale(size_t index) const { return glm::vec2(pets[index].scaleX, pets[index].scaleY) * PetRecord::scaleUnit; }
+	AnimationStates getState(size_t index) const { return (AnimationStates)(pets[index].flags & PetRecord::stateMask); }
+	uint64_t getStateStartTick(size_t index) const { return tickCount - pets[index].stateAge; }
+	bool isFlipped(size_t index) const { return (pets[index].flags & PetRecord::flippedFlag) != 0; }
+	uint32_t getSlot(size_t index) const { return pets[index].slot; }
+	// the same as World::getFrameIndex
+	int getFrameIndex(size_t index) const;
+
+private:
+	const PetRecord* pets;
+	size_t count;
+	uint64_t tickCount;
+	double timestep;
+	float blend;
+};
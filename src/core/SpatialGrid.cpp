@@ -0,0 +1,74 @@
+#include "core/SpatialGrid.h"
+
+SpatialGrid::SpatialGrid(float cellSize, uint32_t bucketCount) : cellSize(cellSize), inverseCellSize(1.0f / cellSize), count(0) {
+	// rounded up to a power of two so a bucket is a mask away
+	uint32_t buckets = 1;
+	while (buckets < bucketCount) {
+		buckets <<= 1;
+	}
+	bucketMask = buckets - 1;
+	heads.assign(buckets, none);
+}
+
+void SpatialGrid::update(uint32_t id, float x, float y) {
+	if (id >= nodes.size()) {
+		nodes.resize((size_t)id + 1, Node{0.0f, 0.0f, 0, 0, none, none, none});
+	}
+
+	Node& node = nodes[id];
+	node.x = x;
+	node.y = y;
+	int32_t cellX = toCell(x), cellY = toCell(y);
+	if (node.bucket != none) {
+		if (cellX == node.cellX && cellY == node.cellY) {
+			return;
+		}
+		unlink(id);
+		--count;
+	}
+	node.cellX = cellX;
+	node.cellY = cellY;
+	link(id);
+	++count;
+}
+
+void SpatialGrid::remove(uint32_t id) {
+	if (id < nodes.size() && nodes[id].bucket != none) {
+		unlink(id);
+		--count;
+	}
+}
+
+void SpatialGrid::clear() {
+	heads.assign(heads.size(), none);
+	for (Node& node : nodes) {
+		node.bucket = none;
+	}
+	count = 0;
+}
+
+void SpatialGrid::link(uint32_t id) {
+	Node& node = nodes[id];
+	uint32_t index = getBucket(node.cellX, node.cellY);
+	node.bucket = index;
+	node.previous = none;
+	node.next = heads[index];
+	if (heads[index] != none) {
+		nodes[heads[index]].previous = id;
+	}
+	heads[index] = id;
+}
+
+void SpatialGrid::unlink(uint32_t id) {
+	Node& node = nodes[id];
+	if (node.previous != none) {
+		nodes[node.previous].next = node.next;
+	}
+	else {
+		heads[node.bucket] = node.next;
+	}
+	if (node.next != none) {
+		nodes[node.next].previous = node.previous;
+	}
+	node.bucket = none;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+// std
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// pets bucketed by the square cell they stand in, finding the pets near a point only visits the
+// cells around it instead of every pet, cells hash into a fixed table so the world needs no bounds
+// every cell is an intrusive list, so moving a pet within its cell only stores the new position and
+// moving it across unlinks and links it in O(1), a tick only updates the pets that moved
+class SpatialGrid {
+public:
+	static constexpr uint32_t none = ~0u;
+
+	explicit SpatialGrid(float cellSize = 0.5f, uint32_t bucketCount = 4096);
+
+	// adds the pet with this id or moves it, ids are indices and the arrays grow to fit
+	void update(uint32_t id, float x, float y);
+	void remove(uint32_t id);
+	void clear();
+	// room for ids below capacity, updating them never reallocates
+	void reserve(size_t capacity) { nodes.reserve(capacity); }
+
+	// calls visit(id, x, y) for the pets in every cell the square of radius around x, y touches, nearest
+	// ring of cells first, until visit returns false, the caller checks the actual distance
+	// positions are the ones last given to update, so queries see one consistent state while pets move
+	template <typename Visit>
+	void query(float x, float y, float radius, Visit&& visit) const {
+		int32_t centerX = toCell(x), centerY = toCell(y);
+		int32_t rings = (int32_t)std::ceil(radius * inverseCellSize);
+		for (int32_t ring = 0; ring <= rings; ++ring) {
+			for (int32_t dy = -ring; dy <= ring; ++dy) {
+				// the ring's top and bottom rows are whole, the rows between only have their two ends
+				int32_t step = (dy == -ring || dy == ring) ? 1 : 2 * ring;
+				for (int32_t dx = -ring; dx <= ring; dx += step) {
+					if (!visitCell(centerX + dx, centerY + dy, visit)) {
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	size_t size() const { return count; }
+	float getCellSize() const { return cellSize; }
+
+private:
+	int32_t toCell(float value) const { return (int32_t)std::floor(value * inverseCellSize); }
+	uint32_t getBucket(int32_t cellX, int32_t cellY) const {
+		return ((uint32_t)cellX * 73856093u ^ (uint32_t)cellY * 19349663u) & bucketMask;
+	}
+	void link(uint32_t id);
+	void unlink(uint32_t id);
+
+	template <typename Visit>
+	bool visitCell(int32_t x, int32_t y, Visit& visit) const {
+		// other cells hashing to the same bucket share its list
+		for (uint32_t id = heads[getBucket(x, y)]; id != none; id = nodes[id].next) {
+			const Node& node = nodes[id];
+			if (node.cellX == x && node.cellY == y && !visit(id, node.x, node.y)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	float cellSize;
+	float inverseCellSize;
+	uint32_t bucketMask;
+	std::vector<uint32_t> heads; // first pet of each bucket
+
+	// one per pet, a query reads everything it needs about a pet from one cache line
+	struct Node {
+		float x, y;
+		int32_t cellX, cellY;
+		uint32_t next, previous;
+		uint32_t bucket; // none while not in the grid
+	};
+	std::vector<Node> nodes;
+	size_t count;
+};
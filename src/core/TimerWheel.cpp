@@ -0,0 +1,109 @@
+#include "core/TimerWheel.h"
+
+void TimerWheel::reset(uint64_t tick) {
+	for (auto& level : slots) {
+		for (List& slot : level) {
+			slot = List();
+		}
+	}
+	overflow = List();
+	blocks.clear();
+	freeBlocks = none;
+	current = tick;
+	count = 0;
+}
+
+// every slot may hold a partly filled block on top of the full ones
+void TimerWheel::reserve(size_t capacity) {
+	blocks.reserve((capacity + blockSize - 1) / blockSize + levelCount * slotCount + 1);
+}
+
+void TimerWheel::schedule(uint32_t id, uint64_t deadline) {
+	insert({id, deadline});
+	++count;
+}
+
+void TimerWheel::append(List& list, const Entry& entry) {
+	if (list.last == none || blocks[list.last].count == blockSize) {
+		uint32_t block = freeBlocks;
+		if (block != none) {
+			freeBlocks = blocks[block].next;
+		}
+		else {
+			block = (uint32_t)blocks.size();
+			blocks.emplace_back();
+		}
+		blocks[block].count = 0;
+		blocks[block].next = none;
+		if (list.last != none) {
+			blocks[list.last].next = block;
+		}
+		else {
+			list.first = block;
+		}
+		list.last = block;
+	}
+	Block& block = blocks[list.last];
+	block.entries[block.count++] = entry;
+}
+
+void TimerWheel::freeBlock(uint32_t block) {
+	blocks[block].next = freeBlocks;
+	freeBlocks = block;
+}
+
+// an entry sits on the highest level where its deadline and the current tick still differ,
+// it moves down a level each time the wheel reaches the start of its slot
+void TimerWheel::insert(const Entry& entry) {
+	for (int level = 0; level < levelCount; ++level) {
+		int shift = slotBits * (level + 1);
+		if ((entry.deadline >> shift) == (current >> shift)) {
+			append(slots[level][(entry.deadline >> (slotBits * level)) & (slotCount - 1)], entry);
+			return;
+		}
+	}
+	append(overflow, entry);
+}
+
+void TimerWheel::cascade(int level) {
+	List& slot = level < levelCount ? slots[level][(current >> (slotBits * level)) & (slotCount - 1)] : overflow;
+	// taken off first, entries can land back in the slot being emptied, a block is only freed once
+	// all its entries moved, so inserting never writes over one still being read
+	uint32_t block = slot.first;
+	slot = List();
+	while (block != none) {
+		uint32_t next = blocks[block].next;
+		for (uint32_t i = 0; i < blocks[block].count; ++i) {
+			// copied, inserting may grow the pool under it
+			Entry entry = blocks[block].entries[i];
+			insert(entry);
+		}
+		freeBlock(block);
+		block = next;
+	}
+}
+
+void TimerWheel::advance(uint64_t tick, std::vector<Entry>& fired) {
+	while (current < tick) {
+		++current;
+
+		// entering a new slot on a level brings its entries down, highest level first
+		int level = 1;
+		while (level <= levelCount && (current & ((1ull << (slotBits * level)) - 1)) == 0) {
+			++level;
+		}
+		for (int cascaded = level - 1; cascaded >= 1; --cascaded) {
+			cascade(cascaded);
+		}
+
+		List& due = slots[0][current & (slotCount - 1)];
+		for (uint32_t block = due.first; block != none;) {
+			uint32_t next = blocks[block].next;
+			fired.insert(fired.end(), blocks[block].entries, blocks[block].entries + blocks[block].count);
+			count -= blocks[block].count;
+			freeBlock(block);
+			block = next;
+		}
+		due = List();
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// hierarchical timer wheel over ticks, scheduling and firing a deadline are O(1) and a tick with
+// nothing due only looks at one slot, so the cost follows the number of deadlines, not of pets
+// four levels of 64 slots reach 2^24 ticks ahead (three days at 60 Hz), later ones wait in an overflow list
+// slots are lists of fixed size blocks from one shared pool, so once the pool holds as many blocks
+// as deadlines ever need at once nothing allocates, however the deadlines bunch up in slots
+class TimerWheel {
+public:
+	struct Entry {
+		uint32_t id;
+		uint64_t deadline;
+	};
+
+	explicit TimerWheel(uint64_t tick = 0) { reset(tick); }
+
+	// drops every deadline, the wheel continues as if it had just fired tick
+	void reset(uint64_t tick);
+
+	// room for this many deadlines at once before scheduling allocates
+	void reserve(size_t capacity);
+
+	// deadline has to be after the last fired tick
+	void schedule(uint32_t id, uint64_t deadline);
+
+	// fires every tick up to and including tick, appending their entries to fired in deadline order
+	void advance(uint64_t tick, std::vector<Entry>& fired);
+
+	// earliest deadline live(entry) accepts, max when there is none, entries it turns down are the
+	// caller's stale ones and are skipped, slots hold later deadlines level by level and slot by slot,
+	// so only the slots up to the first one holding a live entry are looked at, however many there are
+	template <typename Live>
+	uint64_t getNextDeadline(Live&& live) const {
+		for (int level = 0; level < levelCount; ++level) {
+			int currentSlot = (int)((current >> (slotBits * level)) & (slotCount - 1));
+			for (int slot = currentSlot + 1; slot < slotCount; ++slot) {
+				uint64_t earliest = getEarliest(slots[level][slot], live);
+				if (earliest != std::numeric_limits<uint64_t>::max()) {
+					return earliest;
+				}
+			}
+		}
+		return getEarliest(overflow, live);
+	}
+
+	uint64_t getTick() const { return current; }
+	size_t size() const { return count; }
+
+private:
+	static constexpr int slotBits = 6;
+	static constexpr int slotCount = 1 << slotBits;
+	static constexpr int levelCount = 4;
+
+	static constexpr uint32_t none = ~0u;
+	static constexpr uint32_t blockSize = 32;
+
+	// entries are kept in blocks so firing and cascading read them contiguously
+	struct Block {
+		Entry entries[blockSize];
+		uint32_t count;
+		uint32_t next;
+	};
+
+	// blocks first to last in the order entries were added, fired and cascaded in that order
+	struct List {
+		uint32_t first = none;
+		uint32_t last = none;
+	};
+
+	void insert(const Entry& entry);
+	void append(List& list, const Entry& entry);
+	void freeBlock(uint32_t block);
+	void cascade(int level);
+
+	template <typename Live>
+	uint64_t getEarliest(const List& list, Live& live) const {
+		uint64_t earliest = std::numeric_limits<uint64_t>::max();
+		for (uint32_t block = list.first; block != none; block = blocks[block].next) {
+			for (uint32_t i = 0; i < blocks[block].count; ++i) {
+				if (blocks[block].entries[i].deadline < earliest && live(blocks[block].entries[i])) {
+					earliest = blocks[block].entries[i].deadline;
+				}
+			}
+		}
+		return earliest;
+	}
+
+	List slots[levelCount][slotCount];
+	List overflow;
+	std::vector<Block> blocks;
+	uint32_t freeBlocks; // linked through next
+	uint64_t current;
+	size_t count;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// running mean, deviation and worst of a series of durations, e.g. one thread's frame times, whose
+// deviation is its jitter, or input to photon latencies, nothing is stored per sample
+class TimingStats {
+public:
+	void add(uint64_t nanoseconds) {
+		double milliseconds = nanoseconds * 1e-6;
+		++count;
+		double delta = milliseconds - mean;
+		mean += delta / count;
+		squares += delta * (milliseconds - mean);
+		max = std::max(max, milliseconds);
+	}
+
+	void reset() { *this = TimingStats(); }
+
+	uint64_t getCount() const { return count; }
+	double getMean() const { return mean; }
+	double getDeviation() const { return count > 1 ? std::sqrt(squares / (count - 1)) : 0.0; }
+	double getMax() const { return max; }
+
+private:
+	uint64_t count = 0;
+	double mean = 0.0;    // milliseconds
+	double squares = 0.0; // summed squared differences from the mean, Welford's update
+	double max = 0.0;
+};
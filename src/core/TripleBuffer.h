@@ -0,0 +1,59 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+
+// hands the latest of a stream of values from one writer thread to one reader thread without locks,
+// the writer fills the back slot and publishes it, the reader takes the newest published slot and
+// reads it for as long as it likes, neither ever waits for the other and values the reader was too
+// slow for are overwritten
+template <typename T>
+class TripleBuffer {
+public:
+	// writer only, the slot to fill, it still holds whatever was written into it two publishes ago
+	T& getBack() { return slots[back]; }
+
+	// writer only, swaps the filled back slot with the shared one and wakes a waiting reader
+	void publish() {
+		back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+		signal.fetch_add(1, std::memory_order_release);
+		signal.notify_one();
+	}
+
+	// reader only, moves to the newest published slot, returns false when nothing was published since the last take
+	bool take() {
+		if (!(middle.load(std::memory_order_relaxed) & freshBit)) {
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+
+	// reader only, what the last successful take moved to
+	const T& getFront() const { return slots[front]; }
+
+	// reader only, blocks until something is published or wake is called
+	void wait() {
+		uint32_t seen = signal.load(std::memory_order_acquire);
+		if (!(middle.load(std::memory_order_acquire) & freshBit)) {
+			signal.wait(seen, std::memory_order_acquire);
+		}
+	}
+
+	// ends a reader's wait without publishing, e.g. to have it shut down
+	void wake() {
+		signal.fetch_add(1, std::memory_order_release);
+		signal.notify_one();
+	}
+
+private:
+	static constexpr uint8_t indexMask = 3;
+	static constexpr uint8_t freshBit = 4; // set in middle while the reader hasn't taken it
+
+	T slots[3];
+	uint8_t back = 0;
+	uint8_t front = 1;
+	std::atomic<uint8_t> middle{2};
+	std::atomic<uint32_t> signal{0};
+};
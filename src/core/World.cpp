@@ -0,0 +1,931 @@
+#include "core/World.h"
+
+// core
+#include "core/Kernels.h"
+
+// std
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace {
+	constexpr float arrivalDistance = 0.1f;
+
+	// stream ids below this are pets, the world stream sits above them
+	constexpr uint64_t worldStream = ~0ull;
+
+	// extra nanoseconds on waits so stepping by one lands on the awaited tick despite rounding
+	constexpr double stepPadding = 1000.0;
+
+	constexpr uint32_t notMoving = ~0u;
+	constexpr uint32_t notSettling = ~0u;
+	constexpr uint32_t noFrameGroup = ~0u;
+
+	// share of moving pets past which a tick sweeps the whole population, both give the same positions
+	constexpr float sweepShare = 0.25f;
+
+	// pets per job chunk, moving one costs a few nanoseconds, deciding or advancing one far more
+	constexpr size_t moveChunk = 4096;
+	constexpr size_t decideChunk = 256;
+
+	// pets a neighbour query looks at before settling for what it found, bounds the work per pet in dense crowds
+	constexpr int maxNeighbours = 32;
+
+	// chunks are the same with and without a job system, so per chunk results always combine the same way
+	void forChunks(JobSystem* jobs, size_t count, size_t chunkSize, ChunkBody body) {
+		if (jobs) {
+			jobs->parallelFor(count, chunkSize, body);
+			return;
+		}
+		for (size_t begin = 0; begin < count; begin += chunkSize) {
+			body(begin, std::min(begin + chunkSize, count));
+		}
+	}
+
+	size_t getChunkCount(size_t count, size_t chunkSize) {
+		return (count + chunkSize - 1) / chunkSize;
+	}
+
+	// sign and exponent bits of a float, the power of two starting its binade
+	constexpr uint32_t binadeBits = 0xff800000u;
+	constexpr uint32_t exponentBits = 0x7f800000u;
+
+	// both normal floats with the same sign and exponent, so they share one ulp
+	bool inOneBinade(float a, float b) {
+		uint32_t bitsA = std::bit_cast<uint32_t>(a) & binadeBits;
+		return bitsA == (std::bit_cast<uint32_t>(b) & binadeBits) && (bitsA & exponentBits) != 0 && (bitsA & exponentBits) != exponentBits;
+	}
+
+	// ticks value can go on adding step and stay more than a step and an ulp inside its binade, where
+	// every tick rounds to the same whole number of ulps, unbounded for a step of 0
+	uint64_t getSteadyTicks(float value, float step) {
+		if (step == 0.0f) {
+			return std::numeric_limits<uint64_t>::max();
+		}
+		double low = std::fabs(std::bit_cast<float>(std::bit_cast<uint32_t>(value) & binadeBits));
+		double ulp = low * (1.0 / (1 << (std::numeric_limits<float>::digits - 1)));
+		double size = std::fabs(step);
+		double room = (value > 0.0f) == (step > 0.0f) ? 2.0 * low - std::fabs(value) : std::fabs(value) - low;
+		room -= size + ulp;
+		return room > 0.0 ? (uint64_t)(room / size) : 0;
+	}
+}
+
+World::World(const WorldSettings& settings) : settings(settings), random(settings.seed, worldStream), clockNanoseconds(0), tickCount(0) {
+	resetFrameGroups();
+	// everything sized by the population, a tick's scratch lists can't outgrow it either
+	size_t capacity = settings.capacity;
+	if (capacity > 0) {
+		population.reserve(capacity);
+		slotIndex.reserve(capacity);
+		slotGeneration.reserve(capacity);
+		freeSlots.reserve(capacity);
+		moving.reserve(capacity);
+		movingSlot.reserve(capacity);
+		movingTargetX.reserve(capacity);
+		movingTargetY.reserve(capacity);
+		movingVelocityX.reserve(capacity);
+		movingVelocityY.reserve(capacity);
+		settling.reserve(capacity);
+		settlingSlot.reserve(capacity);
+		grid.reserve(capacity);
+		stopping.reserve(capacity);
+		// every group has a pet in it, a group left empty is reused at once and its flip dropped when it fires
+		frameGroups.reserve(capacity);
+		freeFrameGroups.reserve(capacity);
+		petFrameGroup.reserve(capacity);
+		frameTimers.reserve(2 * capacity);
+		scratch.reserve(getScratchBytes());
+		// besides every pet's deadline, up to as many of despawned pets', see despawn
+		timers.reserve(2 * capacity);
+		fired.reserve(2 * capacity);
+	}
+}
+
+PetHandle World::spawn(glm::vec2 position, glm::vec2 scale) {
+	if (settings.capacity > 0 && population.size() >= settings.capacity) {
+		return PetHandle();
+	}
+
+	uint32_t slot;
+	if (freeSlots.empty()) {
+		slot = (uint32_t)slotIndex.size();
+		slotIndex.push_back(freeSlot);
+		slotGeneration.push_back(0);
+	}
+	else {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	// generation 0 is the null handle's
+	slotGeneration[slot] = std::max(slotGeneration[slot] + 1, 1u);
+
+	size_t index = population.add();
+	slotIndex[slot] = (uint32_t)index;
+	population.slot[index] = slot;
+	population.positionX[index] = position.x;
+	population.positionY[index] = position.y;
+	population.previousX[index] = position.x;
+	population.previousY[index] = position.y;
+	population.targetX[index] = position.x;
+	population.targetY[index] = position.y;
+	population.scaleX[index] = scale.x;
+	population.scaleY[index] = scale.y;
+	population.random[index] = RandomStream(settings.seed, spawnCount++);
+	population.flipped[index] = population.random[index].nextBool();
+	enterState(index, AnimationStates::Idle, tickCount);
+
+	movingSlot.push_back(notMoving);
+	settlingSlot.push_back(notSettling);
+	petFrameGroup.push_back(noFrameGroup);
+	stopping.resize(population.size());
+	// without a capacity the world's own arena follows the population, which grows geometrically,
+	// so a new high of moving or deciding pets doesn't spill the next tick onto the heap
+	if (settings.capacity == 0) {
+		scratch.reserve(getScratchBytes());
+	}
+	if (settings.social.enabled) {
+		grid.update((uint32_t)index, position.x, position.y);
+	}
+	track(index);
+	return getHandle(index);
+}
+
+bool World::despawn(PetHandle handle) {
+	if (!isAlive(handle)) {
+		return false;
+	}
+	Population& p = population;
+	size_t index = slotIndex[handle.slot];
+	size_t last = p.size() - 1;
+
+	// out of the moving and settling lists, its frame group and the grid, each in O(1)
+	if (movingSlot[index] != notMoving) {
+		removeMoving(index);
+	}
+	leaveFrameGroup(index);
+	uint32_t settlingIndex = settlingSlot[index];
+	if (settlingIndex != notSettling) {
+		settlingSlot[settling.back()] = settlingIndex;
+		settling[settlingIndex] = settling.back();
+		settling.pop_back();
+	}
+	if (settings.social.enabled) {
+		grid.remove((uint32_t)index);
+	}
+
+	// the last pet moves into the hole, everything holding its index follows
+	if (index != last) {
+		if (movingSlot[last] != notMoving) {
+			moving[movingSlot[last]] = (uint32_t)index;
+		}
+		movingSlot[index] = movingSlot[last];
+		if (settlingSlot[last] != notSettling) {
+			settling[settlingSlot[last]] = (uint32_t)index;
+		}
+		settlingSlot[index] = settlingSlot[last];
+		petFrameGroup[index] = petFrameGroup[last];
+		if (settings.social.enabled) {
+			grid.remove((uint32_t)last);
+			grid.update((uint32_t)index, p.positionX[last], p.positionY[last]);
+		}
+		slotIndex[p.slot[last]] = (uint32_t)index;
+	}
+	// its deadline stays in the wheel and is dropped when it fires, finding it there would mean
+	// searching a slot, instead the wheel is rebuilt once stale deadlines outnumber the capacity, or
+	// the pets without one, which bounds the wheel to twice that at an amortized O(1) per despawn
+	if (p.stateEndTick[index] != 0) {
+		++staleTimers;
+	}
+	p.remove(index);
+	movingSlot.pop_back();
+	settlingSlot.pop_back();
+	petFrameGroup.pop_back();
+	stopping.pop_back();
+	if (staleTimers > std::max<size_t>(settings.capacity, p.size())) {
+		rebuildTimers();
+	}
+
+	// followers notice on their next tick, see followLeader
+	slotIndex[handle.slot] = freeSlot;
+	++slotGeneration[handle.slot];
+	freeSlots.push_back(handle.slot);
+	return true;
+}
+
+void World::setJobSystem(JobSystem* jobSystem) {
+	jobs = jobSystem;
+	// a tick decides at most the pets whose timer fired and those arriving, twice the population
+	if (jobs && settings.capacity > 0) {
+		jobs->reserve(getChunkCount(2 * (size_t)settings.capacity, std::min(moveChunk, decideChunk)));
+	}
+}
+
+// the arrivals, then either what interact adds or the pets deciding and their picks, plus a few
+// bytes of alignment between arrays
+size_t World::getScratchBytes() const {
+	size_t capacity = std::max<size_t>(settings.capacity, population.capacity());
+	size_t chunkBytes = sizeof(size_t) * getChunkCount(capacity, std::min(moveChunk, decideChunk));
+	size_t arrivalBytes = sizeof(uint32_t) * capacity;
+	size_t interactBytes = sizeof(uint32_t) * capacity + chunkBytes;
+	size_t decideBytes = 2 * sizeof(uint32_t) * 2 * capacity;
+	return arrivalBytes + chunkBytes + std::max(interactBytes, decideBytes) + 64;
+}
+
+int World::step(double dt) {
+	return stepNanoseconds((uint64_t)std::llround(std::max(dt, 0.0) * 1e9));
+}
+
+int World::stepNanoseconds(uint64_t nanoseconds) {
+	clockNanoseconds += nanoseconds;
+	size_t transitions = 0;
+	return runTicks(getDueTick(), transitions);
+}
+
+int World::runTicks(uint64_t dueTick, size_t& transitions) {
+	// after a sleep or a hitch the backlog is caught up in at most maxStepsPerUpdate steps, each
+	// covering several ticks, so the first frame back costs a bounded amount of work
+	uint64_t backlog = dueTick > tickCount ? dueTick - tickCount : 0;
+	uint64_t maxSteps = std::max(settings.maxStepsPerUpdate, 1u);
+	uint32_t ticksPerStep = (uint32_t)std::min<uint64_t>((backlog + maxSteps - 1) / maxSteps, std::numeric_limits<uint32_t>::max());
+
+	int steps = 0;
+	while (tickCount < dueTick) {
+		transitions += tick((uint32_t)std::min<uint64_t>(ticksPerStep, dueTick - tickCount));
+		++steps;
+	}
+	return steps;
+}
+
+size_t World::advance(double seconds) {
+	clockNanoseconds += (uint64_t)std::llround(std::max(seconds, 0.0) * 1e9);
+	uint64_t dueTick = getDueTick();
+	if (dueTick <= tickCount) {
+		return 0;
+	}
+
+	// pets reacting to each other can't be run one at a time, they are stepped in at most
+	// maxStepsPerUpdate steps like a long frame, coarser but just as bounded
+	if (settings.social.enabled) {
+		size_t transitions = 0;
+		runTicks(dueTick, transitions);
+		return transitions;
+	}
+
+	// pets never affect each other and each decides from its own random stream, so every pet is
+	// run to the due tick on its own, jumping from one transition to the next
+	Population& p = population;
+	uint64_t startTick = tickCount;
+	FrameArena& arena = getArena();
+	FrameArena::Scope scope(arena);
+	std::span<size_t> chunkResults = arena.allocateArray<size_t>(getChunkCount(p.size(), decideChunk));
+	forChunks(jobs, p.size(), decideChunk, [&](size_t begin, size_t end) {
+		size_t transitions = 0;
+		for (size_t i = begin; i < end; ++i) {
+			transitions += advancePet(i, startTick, dueTick);
+		}
+		chunkResults[begin / decideChunk] = transitions;
+	});
+
+	size_t transitions = 0;
+	for (size_t chunkTransitions : chunkResults) {
+		transitions += chunkTransitions;
+	}
+
+	// the pets' own timelines never went through the wheel, it restarts from their final states, pets
+	// join frame groups in order of their state and start so those that share one find it made
+	tickCount = dueTick;
+	timers.reset(tickCount - 1);
+	staleTimers = 0;
+	resetFrameGroups();
+	std::span<uint32_t> joining = arena.allocateArray<uint32_t>(p.size());
+	for (size_t i = 0; i < p.size(); ++i) {
+		joining[i] = (uint32_t)i;
+	}
+	std::sort(joining.begin(), joining.end(), [&](uint32_t a, uint32_t b) {
+		return p.state[a] != p.state[b] ? p.state[a] < p.state[b] : p.stateStartTick[a] < p.stateStartTick[b];
+	});
+	for (uint32_t index : joining) {
+		joinFrameGroup(index);
+	}
+	for (size_t i = 0; i < p.size(); ++i) {
+		track(i);
+	}
+
+	// nothing to blend across a jump, pets are drawn where they ended up
+	p.previousX = p.positionX;
+	p.previousY = p.positionY;
+	for (uint32_t index : settling) {
+		settlingSlot[index] = notSettling;
+	}
+	settling.clear();
+	return transitions;
+}
+
+// runs one pet from startTick to dueTick, returns its number of transitions
+size_t World::advancePet(size_t i, uint64_t startTick, uint64_t dueTick) {
+	Population& p = population;
+	uint64_t petTick = startTick;
+	size_t transitions = 0;
+	while (petTick < dueTick) {
+		uint64_t remaining = dueTick - petTick;
+		bool moving = p.velocityX[i] != 0.0f || p.velocityY[i] != 0.0f;
+
+		uint64_t ticks;
+		bool ended;
+		if (moving) {
+			ticks = walk(i, remaining, ended);
+		}
+		else if (p.stateEndTick[i] != 0) {
+			ticks = std::min(p.stateEndTick[i] - petTick + 1, remaining);
+			ended = ticks == p.stateEndTick[i] - petTick + 1;
+		}
+		else {
+			break;
+		}
+		petTick += ticks;
+		if (!ended) {
+			break;
+		}
+
+		// the decision happens on the last tick of the leg, the same tick stepping would take it on
+		if (moving) {
+			arrived(i);
+		}
+		follow(i, settings.behavior.decide((AnimationStates)p.state[i], p.random[i]), petTick - 1);
+		++transitions;
+	}
+	return transitions;
+}
+
+// moves the pet tick by tick like stepping one tick at a time does, for at most maxTicks ticks or
+// until it arrives, returns the ticks taken and sets reached when the last of them arrived
+// within a binade every tick adds the same whole number of ulps, ties to even included once it added
+// the same twice, so from there the ticks up to near the binade's edge or the target are one multiply
+// and a leg costs a few ticks per binade it crosses, the rest are exactly the kernels' float math
+uint64_t World::walk(size_t index, uint64_t maxTicks, bool& reached) {
+	Population& p = population;
+	float x = p.positionX[index], y = p.positionY[index];
+	float targetX = p.targetX[index], targetY = p.targetY[index];
+	float velocityX = p.velocityX[index], velocityY = p.velocityY[index];
+	float deltaTime = (float)settings.timestep;
+	float radiusSquared = arrivalDistance * arrivalDistance;
+
+	// where the pet was one and two ticks ago, NaN until it has been
+	float lastX = NAN, lastY = NAN, olderX = NAN, olderY = NAN;
+	// the binades a jump was last tried in, once tried the next is only possible in other binades
+	uint64_t triedBinades = 0;
+	uint64_t taken = 0;
+	reached = false;
+	while (taken < maxTicks) {
+		uint64_t binades = (uint64_t)(std::bit_cast<uint32_t>(x) & binadeBits) << 32 | (std::bit_cast<uint32_t>(y) & binadeBits);
+		if (binades != triedBinades) {
+			float stepX = x - lastX, stepY = y - lastY;
+			bool steadyX = stepX == lastX - olderX && (stepX == 0.0f || inOneBinade(olderX, x));
+			bool steadyY = stepY == lastY - olderY && (stepY == 0.0f || inOneBinade(olderY, y));
+			// binades narrower than a few ticks near 0 aren't worth a try
+			bool wide = std::fabs(x) >= 8.0f * std::fabs(stepX) && std::fabs(y) >= 8.0f * std::fabs(stepY);
+			if (steadyX && steadyY) {
+				triedBinades = binades;
+			}
+			if (steadyX && steadyY && wide) {
+				// stops two ticks' travel short of where the arrival test could pass
+				double toX = (double)targetX - x, toY = (double)targetY - y;
+				double distance = toY == 0.0 ? std::fabs(toX) : std::sqrt(toX * toX + toY * toY);
+				double travel = stepY == 0.0f ? std::fabs(stepX) : std::sqrt((double)stepX * stepX + (double)stepY * stepY);
+				double safeTicks = std::min((distance - arrivalDistance) / travel - 2.0, (double)(maxTicks - taken));
+				uint64_t jump = std::min({getSteadyTicks(x, stepX), getSteadyTicks(y, stepY), safeTicks > 0.0 ? (uint64_t)safeTicks : 0});
+				if (jump > 1) {
+					// exact in doubles, every position on the way is a multiple of the binade's ulp
+					x = (float)((double)x + (double)stepX * (double)jump);
+					y = (float)((double)y + (double)stepY * (double)jump);
+					lastX = x - stepX;
+					lastY = y - stepY;
+					olderX = lastX - stepX;
+					olderY = lastY - stepY;
+					taken += jump;
+					continue;
+				}
+			}
+		}
+
+		olderX = lastX;
+		olderY = lastY;
+		lastX = x;
+		lastY = y;
+		movePet(x, y, velocityX, velocityY, deltaTime);
+		++taken;
+		if (hasArrived(x, y, targetX, targetY, velocityX, velocityY, radiusSquared)) {
+			reached = true;
+			break;
+		}
+	}
+	p.positionX[index] = x;
+	p.positionY[index] = y;
+	return taken;
+}
+
+uint64_t World::getDueTick() const {
+	// the tick count follows from the total time alone, so nothing accumulates rounding error
+	return (uint64_t)((double)clockNanoseconds / (settings.timestep * 1e9));
+}
+
+float World::getBlend() const {
+	double sinceTick = (double)clockNanoseconds - (double)tickCount * settings.timestep * 1e9;
+	return (float)std::clamp(sinceTick / (settings.timestep * 1e9), 0.0, 1.0);
+}
+
+double World::getStateTime(size_t index) const {
+	return ((double)(tickCount - population.stateStartTick[index]) + 0.5) * settings.timestep;
+}
+
+int World::getFrameIndex(size_t index) const {
+	return getAnimationFrame(getAnimation((AnimationStates)population.state[index]), getStateTime(index));
+}
+
+Pet World::getPet(size_t index) const {
+	Pet pet = population.getPet(index);
+	pet.frameIndex = getFrameIndex(index);
+	return pet;
+}
+
+uint64_t World::getNextEventTick() const {
+	if (!moving.empty()) {
+		return tickCount + 1;
+	}
+
+	// a state timer fires during its tick and the change shows once it has run, frame flips are filed
+	// by the tick they show on, deadlines left by despawned pets and emptied groups are passed over
+	const Population& p = population;
+	uint64_t next = frameTimers.getNextDeadline([&](const TimerWheel::Entry& entry) {
+		return frameGroups[entry.id].flipDeadline == entry.deadline;
+	});
+	uint64_t deadline = timers.getNextDeadline([&](const TimerWheel::Entry& entry) {
+		uint32_t index = slotIndex[entry.id];
+		return index != freeSlot && p.stateEndTick[index] == entry.deadline;
+	});
+	if (deadline != std::numeric_limits<uint64_t>::max()) {
+		next = std::min(next, deadline + 1);
+	}
+	return next;
+}
+
+double World::getTimeUntilTick(uint64_t tick) const {
+	if (tick <= tickCount) {
+		return 0.0;
+	}
+	double remaining = (double)tick * settings.timestep * 1e9 - (double)clockNanoseconds;
+	return std::max(remaining + stepPadding, 0.0) * 1e-9;
+}
+
+size_t World::tick(uint32_t ticks) {
+	Population& p = population;
+	size_t count = p.size();
+	float deltaTime = (float)(ticks * settings.timestep);
+
+	// only pets in motion move, pets waiting on a timer cost nothing until the wheel fires it,
+	// once enough of them move the vectorized sweep over everyone beats visiting them one by one
+	// each chunk writes its arrivals where its own pets start, they are packed in chunk order after
+	bool sweep = moving.size() > count * sweepShare;
+	size_t moveCount = sweep ? count : moving.size();
+
+	// the state before this tick is kept to draw from, only pets that moved since differ from it
+	for (uint32_t index : settling) {
+		if (!sweep) {
+			p.previousX[index] = p.positionX[index];
+			p.previousY[index] = p.positionY[index];
+		}
+		settlingSlot[index] = notSettling;
+	}
+	settling.clear();
+
+	// every list below lives until the tick ends, several ticks of a frame reuse the same memory
+	FrameArena& arena = getArena();
+	FrameArena::Scope scope(arena);
+	std::span<uint32_t> arrivals = arena.allocateArray<uint32_t>(moveCount);
+	std::span<size_t> chunkResults = arena.allocateArray<size_t>(getChunkCount(moveCount, moveChunk));
+	forChunks(jobs, moveCount, moveChunk, [&](size_t begin, size_t end) {
+		size_t found;
+		if (sweep) {
+			std::copy(p.positionX.begin() + begin, p.positionX.begin() + end, p.previousX.begin() + begin);
+			std::copy(p.positionY.begin() + begin, p.positionY.begin() + end, p.previousY.begin() + begin);
+			integratePositions(p.positionX.data() + begin, p.positionY.data() + begin, p.velocityX.data() + begin, p.velocityY.data() + begin, end - begin, deltaTime);
+			found = findArrivals(p.positionX.data() + begin, p.positionY.data() + begin, p.targetX.data() + begin, p.targetY.data() + begin,
+				p.velocityX.data() + begin, p.velocityY.data() + begin, end - begin, arrivalDistance, arrivals.data() + begin);
+			for (size_t i = 0; i < found; ++i) {
+				arrivals[begin + i] += (uint32_t)begin;
+			}
+		}
+		else {
+			found = moveListed(p.positionX.data(), p.positionY.data(), p.previousX.data(), p.previousY.data(),
+				movingTargetX.data() + begin, movingTargetY.data() + begin, movingVelocityX.data() + begin, movingVelocityY.data() + begin,
+				moving.data() + begin, end - begin, deltaTime, arrivalDistance, arrivals.data() + begin);
+		}
+		chunkResults[begin / moveChunk] = found;
+	});
+
+	size_t arrivalCount = 0;
+	for (size_t chunk = 0; chunk < chunkResults.size(); ++chunk) {
+		uint32_t* found = arrivals.data() + chunk * moveChunk;
+		std::copy(found, found + chunkResults[chunk], arrivals.data() + arrivalCount);
+		arrivalCount += chunkResults[chunk];
+	}
+	if (settings.social.enabled) {
+		arrivalCount = interact(arrivals, arrivalCount);
+	}
+
+	fired.clear();
+	timers.advance(tickCount + ticks - 1, fired);
+
+	// decisions are taken on the last tick a step covers, new states start there
+	tickCount += ticks - 1;
+	// the wheel holds slots, a despawned pet's deadline still fires, and a pet spawned into its slot
+	// may fire on the same tick, each pet decides once and only on its own deadline
+	std::span<uint32_t> deciding = arena.allocateArray<uint32_t>(std::min(fired.size(), count) + arrivalCount);
+	size_t firedCount = 0;
+	for (const TimerWheel::Entry& entry : fired) {
+		uint32_t index = slotIndex[entry.id];
+		if (index != freeSlot && p.stateEndTick[index] == entry.deadline && !stopping[index]) {
+			stopping[index] = 1;
+			deciding[firedCount++] = index;
+		}
+		else if (staleTimers > 0) {
+			--staleTimers;
+		}
+	}
+	for (size_t i = 0; i < firedCount; ++i) {
+		stopping[deciding[i]] = 0;
+	}
+	std::copy(arrivals.begin(), arrivals.begin() + arrivalCount, deciding.begin() + firedCount);
+	deciding = deciding.first(firedCount + arrivalCount);
+
+	// every pet whose state ended picks its next one in batches, then each enters it, touching only
+	// its own fields, the wheel and the moving list are shared so filing them stays on this thread
+	std::span<uint32_t> picked = arena.allocateArray<uint32_t>(deciding.size());
+	forChunks(jobs, deciding.size(), decideChunk, [&](size_t begin, size_t end) {
+		for (size_t i = std::max(begin, firedCount); i < end; ++i) {
+			arrived(deciding[i]);
+		}
+		settings.behavior.sample(deciding.data() + begin, end - begin, p.state.data(), p.random.data(), picked.data() + begin);
+		for (size_t i = begin; i < end; ++i) {
+			follow(deciding[i], picked[i], tickCount);
+		}
+	});
+	for (uint32_t index : deciding) {
+		track(index);
+	}
+
+	// animation frames need no work, they follow from the start tick, see getFrameIndex, only the
+	// groups whose frame flipped during this step are filed again for their next flip
+	fired.clear();
+	frameTimers.advance(tickCount + 1, fired);
+	for (const TimerWheel::Entry& entry : fired) {
+		if (frameGroups[entry.id].flipDeadline == entry.deadline) {
+			fileFrameGroup(entry.id, tickCount + 1);
+		}
+	}
+	++tickCount;
+	return deciding.size();
+}
+
+// pets only react to where the others stand after this tick's moves and each only writes its own
+// fields, so the outcome doesn't depend on the order or the threads pets are visited on
+// adds the walkers that stop short behind another pet to the arrivals, returns the new count
+size_t World::interact(std::span<uint32_t> arrivals, size_t arrivalCount) {
+	Population& p = population;
+	for (uint32_t index : moving) {
+		grid.update(index, p.positionX[index], p.positionY[index]);
+	}
+	for (size_t i = 0; i < arrivalCount; ++i) {
+		stopping[arrivals[i]] = 1;
+	}
+
+	FrameArena& arena = getArena();
+	FrameArena::Scope scope(arena);
+	std::span<uint32_t> blocked = arena.allocateArray<uint32_t>(moving.size());
+	std::span<size_t> chunkResults = arena.allocateArray<size_t>(getChunkCount(moving.size(), moveChunk));
+	forChunks(jobs, moving.size(), moveChunk, [&](size_t begin, size_t end) {
+		size_t found = 0;
+		for (size_t slot = begin; slot < end; ++slot) {
+			uint32_t index = moving[slot];
+			if (stopping[index]) {
+				continue;
+			}
+			if (!p.leader[index].isNull()) {
+				followLeader(index);
+				syncMoving(index);
+			}
+			if (isBlocked(index)) {
+				blocked[begin + found++] = index;
+			}
+		}
+		chunkResults[begin / moveChunk] = found;
+	});
+
+	for (size_t i = 0; i < arrivalCount; ++i) {
+		stopping[arrivals[i]] = 0;
+	}
+	for (size_t chunk = 0; chunk < chunkResults.size(); ++chunk) {
+		const uint32_t* found = blocked.data() + chunk * moveChunk;
+		std::copy(found, found + chunkResults[chunk], arrivals.data() + arrivalCount);
+		arrivalCount += chunkResults[chunk];
+	}
+	return arrivalCount;
+}
+
+// heads for the spot followDistance short of where the leader is now, on the follower's side
+void World::followLeader(size_t index) {
+	Population& p = population;
+	size_t leader = getLeaderIndex(index);
+	glm::vec2 position(p.positionX[index], p.positionY[index]);
+
+	// the leader was despawned, the follower stops where it is
+	if (leader == size()) {
+		p.leader[index] = PetHandle();
+		p.targetX[index] = position.x;
+		p.targetY[index] = position.y;
+		return;
+	}
+	glm::vec2 toLeader = glm::vec2(p.positionX[leader], p.positionY[leader]) - position;
+	float distance = glm::length(toLeader);
+
+	// close enough already, it arrives where it stands on the next tick
+	if (distance <= settings.social.followDistance + arrivalDistance) {
+		p.targetX[index] = position.x;
+		p.targetY[index] = position.y;
+		return;
+	}
+	glm::vec2 direction = toLeader / distance;
+	glm::vec2 target = position + direction * (distance - settings.social.followDistance);
+	glm::vec2 velocity = direction * settings.behavior.states[p.state[index]].speed;
+	p.targetX[index] = target.x;
+	p.targetY[index] = target.y;
+	p.velocityX[index] = velocity.x;
+	p.velocityY[index] = velocity.y;
+	if (direction.x != 0.0f) {
+		p.flipped[index] = direction.x > 0.0f;
+	}
+}
+
+// another pet in front of a walker closer than personalSpace, its leader doesn't count
+bool World::isBlocked(size_t index) const {
+	const Population& p = population;
+	float x = p.positionX[index], y = p.positionY[index];
+	float space = settings.social.personalSpace;
+	size_t leader = getLeaderIndex(index);
+
+	bool blockedAhead = false;
+	int visited = 0;
+	grid.query(x, y, space, [&](uint32_t other, float otherX, float otherY) {
+		float dx = otherX - x, dy = otherY - y;
+		if (other != index && other != leader && dx * p.velocityX[index] + dy * p.velocityY[index] > 0.0f && dx * dx + dy * dy < space * space) {
+			blockedAhead = true;
+			return false;
+		}
+		return ++visited < maxNeighbours;
+	});
+	return blockedAhead;
+}
+
+size_t World::getLeaderIndex(size_t index) const {
+	return getIndex(population.leader[index]);
+}
+
+// the nearest other pet within followRadius among the first few found, SpatialGrid::none when there is none
+uint32_t World::findLeader(size_t index, float& leaderX, float& leaderY) const {
+	const Population& p = population;
+	float x = p.positionX[index], y = p.positionY[index];
+	float radius = settings.social.followRadius;
+
+	uint32_t nearest = SpatialGrid::none;
+	float nearestDistance = radius * radius;
+	int visited = 0;
+	grid.query(x, y, radius, [&](uint32_t other, float otherX, float otherY) {
+		float distance = (otherX - x) * (otherX - x) + (otherY - y) * (otherY - y);
+		if (other != index && (distance < nearestDistance || (distance == nearestDistance && other < nearest))) {
+			nearest = other;
+			nearestDistance = distance;
+			leaderX = otherX;
+			leaderY = otherY;
+		}
+		return ++visited < maxNeighbours;
+	});
+	return nearest;
+}
+
+// enters what the behavior tables picked to follow the pet's state, see core/Behavior.h
+void World::follow(size_t index, uint32_t transitionIndex, uint64_t tick) {
+	const Transition& transition = settings.behavior.transitions[transitionIndex];
+	if (transition.newTarget) {
+		pickTarget(index);
+	}
+	enterState(index, (AnimationStates)transition.nextState, tick);
+}
+
+void World::arrived(size_t index) {
+	// a long step can carry a pet past its target, it stops there instead of running on
+	Population& p = population;
+	float dx = p.targetX[index] - p.positionX[index];
+	float dy = p.targetY[index] - p.positionY[index];
+	if (dx * p.velocityX[index] + dy * p.velocityY[index] < 0.0f) {
+		p.positionX[index] = p.targetX[index];
+		p.positionY[index] = p.targetY[index];
+	}
+}
+
+void World::pickTarget(size_t index) {
+	Population& p = population;
+	p.leader[index] = PetHandle();
+	// positions come from the grid, which isn't written while pets decide, so every pet finds the
+	// same leader on any thread
+	if (settings.social.enabled && p.random[index].nextFloat() < settings.social.followChance) {
+		float leaderX, leaderY;
+		uint32_t leader = findLeader(index, leaderX, leaderY);
+		if (leader != SpatialGrid::none) {
+			p.leader[index] = getHandle(leader);
+			p.targetX[index] = leaderX;
+			p.targetY[index] = leaderY;
+			return;
+		}
+	}
+	p.targetX[index] = p.random[index].nextFloat(settings.minX, settings.maxX);
+	p.targetY[index] = 0.0f;
+}
+
+void World::enterState(size_t index, AnimationStates state, uint64_t tick) {
+	Population& p = population;
+	p.state[index] = state;
+
+	// frames count from the state change so they can be derived from the start tick alone
+	p.stateStartTick[index] = tick;
+	p.stateEndTick[index] = 0;
+	p.velocityX[index] = 0.0f;
+	p.velocityY[index] = 0.0f;
+
+	const StateBehavior& behavior = settings.behavior.states[state];
+	if (behavior.speed > 0.0f) {
+		// a leg is a straight line so the velocity is fixed until arrival, only followers turn, see followLeader
+		glm::vec2 toTarget(p.targetX[index] - p.positionX[index], p.targetY[index] - p.positionY[index]);
+		float distance = glm::length(toTarget);
+		glm::vec2 direction = distance > 0.0f ? toTarget / distance : glm::vec2(1.0f, 0.0f);
+		glm::vec2 velocity = direction * behavior.speed;
+
+		p.velocityX[index] = velocity.x;
+		p.velocityY[index] = velocity.y;
+		if (direction.x > 0) {
+			p.flipped[index] = 1;
+		}
+		if (direction.x < 0) {
+			p.flipped[index] = 0;
+		}
+	}
+	else {
+		p.stateEndTick[index] = tick + toTicks(settings.behavior.drawDuration(state, p.random[index]));
+		p.leader[index] = PetHandle();
+	}
+}
+
+// whole ticks closest to a duration in seconds, at least one so the timer runs
+uint32_t World::toTicks(float seconds) const {
+	return (uint32_t)std::max(std::llround(seconds / settings.timestep), 1ll);
+}
+
+// files the pet's new state with the wheel or the moving list, after every state change
+void World::track(size_t index) {
+	bool inMotion = population.velocityX[index] != 0.0f || population.velocityY[index] != 0.0f;
+	uint32_t slot = movingSlot[index];
+	if (inMotion && slot == notMoving) {
+		addMoving(index);
+	}
+	else if (inMotion) {
+		// a new leg, or a walker breaking into a run
+		syncMoving(index);
+	}
+	else if (slot != notMoving) {
+		removeMoving(index);
+		settlingSlot[index] = (uint32_t)settling.size();
+		settling.push_back((uint32_t)index);
+		// where it stopped, arriving can move it back onto its target
+		if (settings.social.enabled) {
+			grid.update((uint32_t)index, population.positionX[index], population.positionY[index]);
+		}
+	}
+
+	if (population.stateEndTick[index] != 0) {
+		timers.schedule(population.slot[index], population.stateEndTick[index]);
+	}
+	joinFrameGroup(index);
+}
+
+void World::addMoving(size_t index) {
+	movingSlot[index] = (uint32_t)moving.size();
+	moving.push_back((uint32_t)index);
+	movingTargetX.push_back(population.targetX[index]);
+	movingTargetY.push_back(population.targetY[index]);
+	movingVelocityX.push_back(population.velocityX[index]);
+	movingVelocityY.push_back(population.velocityY[index]);
+}
+
+// the last moving pet takes over the place in O(1)
+void World::removeMoving(size_t index) {
+	uint32_t slot = movingSlot[index];
+	movingSlot[moving.back()] = slot;
+	moving[slot] = moving.back();
+	movingTargetX[slot] = movingTargetX.back();
+	movingTargetY[slot] = movingTargetY.back();
+	movingVelocityX[slot] = movingVelocityX.back();
+	movingVelocityY[slot] = movingVelocityY.back();
+	moving.pop_back();
+	movingTargetX.pop_back();
+	movingTargetY.pop_back();
+	movingVelocityX.pop_back();
+	movingVelocityY.pop_back();
+	movingSlot[index] = notMoving;
+}
+
+// after the moving pet's target or velocity changed, only writes its own place so threads can call it
+void World::syncMoving(size_t index) {
+	uint32_t slot = movingSlot[index];
+	movingTargetX[slot] = population.targetX[index];
+	movingTargetY[slot] = population.targetY[index];
+	movingVelocityX[slot] = population.velocityX[index];
+	movingVelocityY[slot] = population.velocityY[index];
+}
+
+// moves the pet into the group of its state and start, a new one if pets deciding on that tick made none
+void World::joinFrameGroup(size_t index) {
+	const Population& p = population;
+	uint32_t group = petFrameGroup[index];
+	if (group != noFrameGroup && frameGroups[group].state == p.state[index] && frameGroups[group].startTick == p.stateStartTick[index]) {
+		return;
+	}
+	leaveFrameGroup(index);
+
+	group = recentFrameGroups[p.state[index]];
+	if (group == noFrameGroup || frameGroups[group].startTick != p.stateStartTick[index]) {
+		if (freeFrameGroups.empty()) {
+			group = (uint32_t)frameGroups.size();
+			frameGroups.emplace_back();
+		}
+		else {
+			group = freeFrameGroups.back();
+			freeFrameGroups.pop_back();
+		}
+		frameGroups[group] = {p.stateStartTick[index], 0, 0, p.state[index]};
+		recentFrameGroups[p.state[index]] = group;
+		fileFrameGroup(group, tickCount);
+	}
+	++frameGroups[group].pets;
+	petFrameGroup[index] = group;
+}
+
+// an emptied group is free at once, its filed flip no longer matches when it fires and is dropped
+void World::leaveFrameGroup(size_t index) {
+	uint32_t group = petFrameGroup[index];
+	petFrameGroup[index] = noFrameGroup;
+	if (group == noFrameGroup || --frameGroups[group].pets > 0) {
+		return;
+	}
+	frameGroups[group].flipDeadline = 0;
+	if (recentFrameGroups[frameGroups[group].state] == group) {
+		recentFrameGroups[frameGroups[group].state] = noFrameGroup;
+	}
+	freeFrameGroups.push_back(group);
+}
+
+// files the group's first flip after the given tick, the way getFrameIndex counts frames, a group
+// whose animation played out isn't filed again
+void World::fileFrameGroup(uint32_t group, uint64_t after) {
+	FrameGroup& frames = frameGroups[group];
+	const Animation& animation = getAnimation((AnimationStates)frames.state);
+	double ticksPerFrame = animation.frameDuration / settings.timestep;
+	double played = std::floor(((double)(after - frames.startTick) + 0.5) / ticksPerFrame);
+	frames.flipDeadline = 0;
+	if (animation.looping || played < animation.numberOfFrames - 1) {
+		double flip = std::ceil((double)frames.startTick - 0.5 + (played + 1.0) * ticksPerFrame);
+		frames.flipDeadline = std::max((uint64_t)flip, after + 1);
+		frameTimers.schedule(group, frames.flipDeadline);
+	}
+}
+
+// forgets every group and flip, the wheel continues from the current tick
+void World::resetFrameGroups() {
+	frameTimers.reset(tickCount);
+	frameGroups.clear();
+	freeFrameGroups.clear();
+	std::fill(petFrameGroup.begin(), petFrameGroup.end(), noFrameGroup);
+	std::fill(std::begin(recentFrameGroups), std::end(recentFrameGroups), noFrameGroup);
+}
+
+// drops the deadlines of despawned pets by filing every pet's deadline again, see despawn
+void World::rebuildTimers() {
+	const Population& p = population;
+	timers.reset(timers.getTick());
+	for (size_t i = 0; i < p.size(); ++i) {
+		if (p.stateEndTick[i] != 0) {
+			timers.schedule(p.slot[i], p.stateEndTick[i]);
+		}
+	}
+	staleTimers = 0;
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+// core
+#include "core/Behavior.h"
+#include "core/FrameArena.h"
+#include "core/JobSystem.h"
+#include "core/Population.h"
+#include "core/SpatialGrid.h"
+#include "core/TimerWheel.h"
+
+// std
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// how pets react to each other, off by default since then pets are no longer independent, advance
+// has to step them instead of solving each on its own
+struct SocialSettings {
+	bool enabled = false;
+	float personalSpace = 0.3f; // a walker stops short of a pet ahead of it closer than this
+	float followChance = 0.2f;  // chance a pet picking a new target walks behind its nearest neighbour instead
+	float followRadius = 2.0f;  // how far it looks for one
+	float followDistance = 0.4f; // how far behind its leader a follower stops
+};
+
+struct WorldSettings {
+	double timestep = 1.0 / 60.0; // fixed simulation step in seconds, drawing blends between steps so it can be longer than a frame
+	float minX = -5.0f;           // left edge pets wander to
+	float maxX = 5.0f;            // right edge pets wander to
+	uint32_t seed = 0;
+	uint32_t maxStepsPerUpdate = 240; // past this many due ticks, steps cover several ticks each
+	Behavior behavior = capybaraBehavior; // speeds, durations and transition chances of every state
+	SocialSettings social;
+	uint32_t capacity = 0; // pets room is reserved for up front, spawning never reallocates and fails past it, 0 grows as needed and a tick may allocate
+};
+
+// advances every pet with a fixed timestep, no windowing or OpenGL required
+class World {
+public:
+	World() : World(WorldSettings()) {}
+	explicit World(const WorldSettings& settings);
+
+	// adds a pet in the Idle state, returns a null handle when the world is at capacity
+	PetHandle spawn(glm::vec2 position, glm::vec2 scale);
+	// removes the pet in O(1), the last pet takes over its index, returns false for a dead handle
+	bool despawn(PetHandle handle);
+
+	bool isAlive(PetHandle handle) const {
+		return handle.slot < slotGeneration.size() && slotGeneration[handle.slot] == handle.generation && slotIndex[handle.slot] != freeSlot;
+	}
+	// where the pet is in the population arrays until the next spawn or despawn, size() for a dead handle
+	size_t getIndex(PetHandle handle) const { return isAlive(handle) ? slotIndex[handle.slot] : size(); }
+	PetHandle getHandle(size_t index) const { return {population.slot[index], slotGeneration[population.slot[index]]}; }
+	size_t getCapacity() const { return settings.capacity; }
+
+	// advances the world's clock by dt and runs every fixed step now due, returns the number of steps taken
+	int step(double dt);
+	// the same in whole nanoseconds, e.g. differences of Clock readings, which add up without error
+	int stepNanoseconds(uint64_t nanoseconds);
+
+	// jumps seconds ahead for offline runs, timers are solved in closed form and legs a binade of floats
+	// at a time, so it costs a few steps per state transition instead of one per tick, pets end exactly
+	// where stepping one tick at a time leaves them, to the bit, the work still grows with pets times
+	// transitions, so the app catches up a sleep with step's bounded multi-tick steps instead
+	// returns the number of transitions
+	size_t advance(double seconds);
+
+	const Population& getPopulation() const { return population; }
+	Pet getPet(size_t index) const;
+	size_t size() const { return population.size(); }
+
+	// seconds the pet has been in its state, sampled half a tick in because frame boundaries land
+	// exactly on ticks and the renderer's float math must not round across them
+	double getStateTime(size_t index) const;
+	// frame of its sheet the pet shows now, the vertex shader computes the same
+	int getFrameIndex(size_t index) const;
+
+	const WorldSettings& getSettings() const { return settings; }
+	uint64_t getTickCount() const { return tickCount; }
+	double getTime() const { return tickCount * settings.timestep; }
+
+	// how far the clock has run past the last tick, in ticks from 0 to 1, pets are drawn that far
+	// from their previous position to their current one, so drawing trails the simulation by a tick
+	// but moves smoothly however slow the tick rate is next to the display's
+	float getBlend() const;
+	// some pet is between its previous and current position, drawing before the next tick shows something new
+	bool isBlending() const { return !moving.empty() || !settling.empty(); }
+
+	// earliest tick after which some pet has moved, shows a new animation frame or changed state,
+	// nothing on screen can change before it so the caller can sleep until then, read from the state
+	// and frame timer wheels, so finding it costs the same however many pets wait
+	uint64_t getNextEventTick() const;
+
+	// seconds of step() time still needed to reach the given tick
+	double getTimeUntilTick(uint64_t tick) const;
+
+	// every pet's position as of the last tick, for neighbour queries, only kept with social settings enabled
+	const SpatialGrid& getGrid() const { return grid; }
+
+	// spreads stepping and advancing large populations over the job system's threads, nullptr runs
+	// everything on the calling thread, the results are the same either way and for any thread count
+	void setJobSystem(JobSystem* jobSystem);
+
+	// takes each tick's scratch lists from the caller's frame arena, rewound after every tick, nullptr
+	// uses an arena of the world's own, the arena has to outlive the world or the next call here
+	void setFrameArena(FrameArena* arena) { frameArena = arena; }
+	// most arena bytes a tick takes at the world's capacity, or the room the population has without one,
+	// reserved up front a tick never overflows
+	size_t getScratchBytes() const;
+
+	// world level stream for callers placing pets, pets draw from their own streams
+	float randomFloat(float lower, float upper) { return random.nextFloat(lower, upper); }
+	bool randomBool() { return random.nextBool(); }
+
+private:
+	FrameArena& getArena() { return frameArena ? *frameArena : scratch; }
+	size_t tick(uint32_t ticks);
+	int runTicks(uint64_t dueTick, size_t& transitions);
+	size_t interact(std::span<uint32_t> arrivals, size_t arrivalCount);
+	void followLeader(size_t index);
+	bool isBlocked(size_t index) const;
+	uint32_t findLeader(size_t index, float& leaderX, float& leaderY) const;
+	size_t getLeaderIndex(size_t index) const;
+	size_t advancePet(size_t index, uint64_t startTick, uint64_t dueTick);
+	uint64_t walk(size_t index, uint64_t maxTicks, bool& reached);
+	void follow(size_t index, uint32_t transition, uint64_t tick);
+	void arrived(size_t index);
+	void pickTarget(size_t index);
+	void enterState(size_t index, AnimationStates state, uint64_t tick);
+	void track(size_t index);
+	void addMoving(size_t index);
+	void removeMoving(size_t index);
+	void syncMoving(size_t index);
+	void rebuildTimers();
+	void joinFrameGroup(size_t index);
+	void leaveFrameGroup(size_t index);
+	void fileFrameGroup(uint32_t group, uint64_t after);
+	void resetFrameGroups();
+	uint32_t toTicks(float seconds) const;
+	uint64_t getDueTick() const;
+
+	WorldSettings settings;
+	Population population;
+
+	// a tick only touches pets in motion and pets whose state timer fires, the rest wait in the wheel
+	TimerWheel timers;
+	std::vector<uint32_t> moving;     // indices of walking and running pets, unordered
+	std::vector<uint32_t> movingSlot; // each pet's position in moving, notMoving otherwise
+	// what moving a listed pet reads besides its position, in moving's order and kept up to date by
+	// track, so a tick moving few pets reads these straight through instead of four more arrays at random
+	std::vector<float> movingTargetX, movingTargetY;
+	std::vector<float> movingVelocityX, movingVelocityY;
+	std::vector<uint32_t> settling;   // pets that stopped on the last tick, their previous position still differs
+	std::vector<uint32_t> settlingSlot; // each pet's position in settling, notSettling otherwise
+	size_t staleTimers = 0;           // deadlines of despawned pets still in the wheel, see despawn
+
+	// pets that entered the same state on the same tick show the same frames, so frame flips are filed
+	// per group in a wheel of their own and the next one is found without visiting every pet
+	struct FrameGroup {
+		uint64_t startTick;
+		uint64_t flipDeadline; // the tick its next frame shows on, 0 when its frames stopped, see fileFrameGroup
+		uint32_t pets;
+		uint8_t state;
+	};
+	TimerWheel frameTimers;
+	std::vector<FrameGroup> frameGroups;
+	std::vector<uint32_t> freeFrameGroups;
+	std::vector<uint32_t> petFrameGroup;                   // each pet's group, noFrameGroup before it joins one
+	uint32_t recentFrameGroups[numberOfAnimationStates]; // the last group made per state, pets deciding on the same tick join it
+
+	// handles, a slot holds its pet's index while alive and waits in freeSlots after
+	static constexpr uint32_t freeSlot = ~0u;
+	std::vector<uint32_t> slotIndex;
+	std::vector<uint32_t> slotGeneration;
+	std::vector<uint32_t> freeSlots;
+	uint64_t spawnCount = 0; // numbers every pet's random stream, never reused
+
+	// neighbours, only updated for pets that moved
+	SpatialGrid grid;
+
+	// a tick's other scratch lists come from the frame arena, see tick
+	std::vector<TimerWheel::Entry> fired;
+	std::vector<uint8_t> stopping; // marks the pets that arrived this tick, zero between ticks
+
+	JobSystem* jobs = nullptr;
+	FrameArena* frameArena = nullptr;
+	FrameArena scratch; // used without a frame arena
+
+	RandomStream random;
+	uint64_t clockNanoseconds; // all time ever stepped, ticks are due up to clockNanoseconds / timestep
+	uint64_t tickCount;
+};
@@ -25,12 +25,35 @@
 // #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// core
+#include "core/Allocations.h"
+#include "core/Clock.h"
+#include "core/FrameArena.h"
+#include "core/JobSystem.h"
+#include "core/Scheduler.h"
+#include "core/Snapshot.h"
+#include "core/Timing.h"
+#include "core/TripleBuffer.h"
+#include "core/World.h"
+
+// render
+#include "render/Canvas.h"
+#include "render/DamageTracker.h"
+#include "render/Debug.h"
+#include "render/ResourceRegistry.h"
+#include "render/SpriteRenderer.h"
+
 // std
+#include <atomic>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <thread>
 #include <string>
 #include <vector>
 #include <random>
 #include <fstream>
+#include <algorithm>
 
 // mac os
 #include <CoreFoundation/CoreFoundation.h>
@@ -40,6 +63,8 @@ bool allDesktops = true;
 
 void AllDesktopsButton() {
 	allDesktops = !allDesktops;
+	// the loop may be asleep until the next pet event, wake it so the change applies now
+	glfwPostEmptyEvent();
 }
 
 #ifdef __OBJC__
@@ -62,12 +87,22 @@ void AllDesktopsButton() {
 
 int width, height;
 
-float lastFrame, currentFrame;
-float lastPrint = 0.0f;
-float dt = 0.0f;
-
 glm::mat4 projection;
 
+// what the simulation hands the render thread each time it stepped
+struct Frame {
+	WorldSnapshot world;
+	int framebufferWidth = 0, framebufferHeight = 0; // glfw only reads the size on the main thread
+	uint64_t inputNanoseconds = 0; // when the events this frame reflects were handled
+};
+
+// stats are printed this often
+const uint64_t reportNanoseconds = 1000000000ull;
+
+// with --check-allocations frames past this since launch abort on any heap allocation, every
+// container has reached the size it keeps by then
+const uint64_t allocationWarmUpNanoseconds = 10000000000ull;
+
 std::string getResourcePath() {
 	CFBundleRef mainBundle = CFBundleGetMainBundle();
 	CFURLRef resourcesURL = CFBundleCopyResourcesDirectoryURL(mainBundle);
@@ -80,520 +115,6 @@ std::string getResourcePath() {
 	return std::string(path);
 }
 
-float getRandomFloat(float lower, float upper) {
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_real_distribution<> distrib(lower, upper);
-	return distrib(gen);
-}
-
-bool getRandomBool() {
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_int_distribution<> dis(0, 1);
-
-	return dis(gen) == 1;
-}
-
-class Debug {
-public:
-	static void checkOpenGLError() {
-		GLenum error = glGetError();
-		if (error != GL_NO_ERROR) {
-			throw std::runtime_error("OpenGL error occurred: " + std::to_string(error));
-		}
-	}
-};
-class Shader {
-public:
-	Shader() {}
-	Shader(const std::string& vertexFilePath, const std::string& fragmentFilePath) {
-		compile(returnFileContents(vertexFilePath), returnFileContents(fragmentFilePath));
-	}
-	~Shader() { destroy(); }
-
-	void setBool(const std::string& name, bool value) {
-		glUniform1i(getUniformLocation(name), (int)value);
-		Debug::checkOpenGLError();
-	}
-	void setInt(const std::string& name, int value) {
-		glUniform1i(getUniformLocation(name), (int)value);
-		Debug::checkOpenGLError();
-	}
-	void setFloat(const std::string& name, float value) {
-		glUniform1f(getUniformLocation(name), value);
-		Debug::checkOpenGLError();
-	}
-	void setVector2Float(const std::string& name, const float* vec2) {
-		glUniform2fv(getUniformLocation(name), 1, vec2);
-		Debug::checkOpenGLError();
-	}
-	void setVector3Float(const std::string& name, const float* vec3) {
-		glUniform3fv(getUniformLocation(name), 1, vec3);
-		Debug::checkOpenGLError();
-	}
-	void setVector4Float(const std::string& name, const float* vec4) {
-		glUniform4fv(getUniformLocation(name), 1, vec4);
-		Debug::checkOpenGLError();
-	}
-	void setMatrix4Float(const std::string& name, const float* mat4) {
-		glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, mat4);
-		Debug::checkOpenGLError();
-	}
-
-	void bind() { glUseProgram(ID); }
-	void unbind() { glUseProgram(0); }
-	void destroy() { glDeleteProgram(ID); }
-
-	GLuint getID() const { return ID; }
-
-private:
-	std::string returnFileContents(const std::string& filePath) {
-		std::string contents; // contents for the file
-		std::ifstream file(filePath, std::ios::in);
-
-		// if unable to open file
-		if (!file.is_open()) {
-			std::cout << "error reading | " << filePath << " | Maybe wrong file name." << std::endl;
-			return contents;
-		}
-
-		std::string line = "";
-		while (!file.eof()) {
-			std::getline(file, line);
-			contents.append(line + "\n");
-		}
-
-		file.close();
-		return contents;
-	}
-	void compile(const std::string& vertexContents, const std::string& fragmentContents) {
-		const char* vertexSource = vertexContents.c_str();
-		const char* fragmentSource = fragmentContents.c_str();
-
-		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-
-		// compiling vertex shader
-		glShaderSource(vertexShader, 1, &vertexSource, NULL);
-		glCompileShader(vertexShader);
-
-		// compiling fragment shader
-		glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
-		glCompileShader(fragmentShader);
-
-		// checking both shaders for errors
-		compileErrorChecking(vertexShader);
-		compileErrorChecking(fragmentShader);
-
-		// linking shaders
-		ID = glCreateProgram();
-		glAttachShader(ID, vertexShader);
-		glAttachShader(ID, fragmentShader);
-		glLinkProgram(ID);
-
-		// deleting shaders
-		glDeleteShader(vertexShader);
-		glDeleteShader(fragmentShader);
-	}
-	void compileErrorChecking(const GLuint& shaderID) {
-		GLint compileStatus;
-		glGetShaderiv(shaderID, GL_COMPILE_STATUS, &compileStatus);
-
-		// if there is an error
-		if (compileStatus != GL_TRUE) {
-			GLint infoLogLenth;
-
-			glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &infoLogLenth);
-			GLchar* buffer = new GLchar[infoLogLenth];
-
-			GLsizei bufferSize;
-			glGetShaderInfoLog(shaderID, infoLogLenth, &bufferSize, buffer);
-
-			std::cout << buffer << std::endl;
-
-			delete [ ] buffer;
-		}
-	}
-	GLint getUniformLocation(const std::string& name) {
-		GLint location = glGetUniformLocation(ID, name.c_str());
-		if (location == -1) {
-			std::cerr << "Warning: Uniform '" << name << "' not found in shader program with ID: " << ID << std::endl;
-		}
-		return location;
-	}
-
-	GLuint ID;
-};
-class Texture {
-public:
-	Texture() : id(0), data(nullptr), width(0), height(0), nrChannels(0) {}
-	Texture(const std::string& filename) : filename(filename), pixelType(GL_UNSIGNED_BYTE) {
-		loadTexture();
-		setFormat();
-		createOpenGLTexture();
-
-		// freeing memory
-		stbi_image_free(data);
-	}
-
-	Texture(int width, int height, GLenum internalFormat, GLenum imageFormat, GLenum pixelType) : width(width), height(height), internalFormat(internalFormat), imageFormat(imageFormat), pixelType(pixelType)  {
-		createOpenGLTexture();
-	}
-
-	void bind(int slot) {
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, id);
-		Debug::checkOpenGLError();
-	}
-	void unbind() {
-		glBindTexture(GL_TEXTURE_2D, 0);
-	}
-	void destroy() {
-		if (id) {
-			glDeleteTextures(1, &id);
-			id = 0;
-		}
-		if (data) {
-			stbi_image_free(data);
-			data = nullptr;
-		}
-	}
-
-	GLuint getID() const { return id; }
-	int getWidth() const { return width; }
-	int getHeight() const { return height; }
-
-private:
-	void loadTexture() {
-		stbi_set_flip_vertically_on_load(true); // flip the texture
-		data = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
-		if (!data) {
-			std::cout << "Failed to load image" << std::endl;
-		}
-	}
-	void setFormat() {
-		switch (nrChannels) {
-			case 1: internalFormat = imageFormat = GL_RED; break;
-			case 2: internalFormat = imageFormat = GL_RG; break;
-			case 3: internalFormat = imageFormat = GL_RGB; break;
-			case 4: internalFormat = imageFormat = GL_RGBA; break;
-			default: throw std::runtime_error("Unsupported image format: " + filename);
-		}
-	}
-	void createOpenGLTexture() {
-			glGenTextures(1, &id);
-			Debug::checkOpenGLError();
-		glBindTexture(GL_TEXTURE_2D, id);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, imageFormat, pixelType, data);
-		Debug::checkOpenGLError();
-
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
-	}
-
-	std::string filename;
-	unsigned int id;
-	unsigned char *data;
-	int width, height, nrChannels;
-	GLenum internalFormat;
-	GLenum imageFormat;
-	GLenum pixelType;
-};
-
-enum AnimationStates {
-	Walk,
-	Run,
-	Idle,
-	Sit,
-	GetUp
-};
-
-struct Vertex {
-	glm::vec3 position;
-	glm::vec2 texCoord; 
-};
-
-struct Sprite {
-	Texture sheet;
-	AnimationStates state;
-	int numberOfFrames;
-	int currentFrameIndex;
-	float frameDuration;
-
-	Sprite() {}
-	Sprite(Texture s, AnimationStates as, int n, int c, float f) : sheet(s), state(as), numberOfFrames(n), currentFrameIndex(c), frameDuration(f) {}
-};
-
-class Capybara {
-public:
-	Capybara() {}
-	Capybara(glm::vec2 p, glm::vec2 s) : position(p), scale(s), velocity(glm::vec2(0.0f)), targetPosition(glm::vec2(0.0f)) {
-		// loading textures
-		std::string walkFile = getResourcePath() + "/res/sprites/Capybara_Walk.png";
-		std::string runFile  = getResourcePath() + "/res/sprites/Capybara_Run.png";
-		std::string idleFile = getResourcePath() + "/res/sprites/Capybara_Idle.png";
-		std::string sitFile  = getResourcePath() + "/res/sprites/Capybara_Sit.png";
-
-		walk = Sprite(Texture(walkFile), AnimationStates::Walk, 5, 0, 0.15f);
-		run = Sprite(Texture(runFile), AnimationStates::Run, 5, 0, 0.1f);
-		idle = Sprite(Texture(idleFile), AnimationStates::Idle, 5, 0, 0.2f);
-		sit = Sprite(Texture(sitFile), AnimationStates::Sit, 5, 0, 0.1f);
-		getup = Sprite(Texture(sitFile), AnimationStates::GetUp, 5, 0, 0.1f);
-
-		// initial state
-		currentSprite = &idle;
-		state = AnimationStates::Idle;
-		stateTimer = 0.0f;
-
-		// animation variables
-		elapsedTime = 0.0f;
-		flipped = getRandomBool();
-
-		// 2d square
-		vertices = {
-			{{ 0.5f,  0.5f, 0.0f}, {1.0f / (float)currentSprite->numberOfFrames, 1.0f}},
-			{{ 0.5f, -0.5f, 0.0f}, {1.0f / (float)currentSprite->numberOfFrames, 0.0f}},
-			{{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f}},
-			{{-0.5f,  0.5f, 0.0f}, {0.0f, 1.0f}} 
-		};
-		indices = {
-			0, 1, 3,
-			1, 2, 3
-		};
-
-		// generate and bind VAO
-		glGenVertexArrays(1, &vaoID);
-		glBindVertexArray(vaoID);
-
-		// generate and bind VBO
-		glGenBuffers(1, &vboID);
-		glBindBuffer(GL_ARRAY_BUFFER, vboID);
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-
-		// generate and bind EBO
-		glGenBuffers(1, &eboID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-		// set vertex attribute pointers
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-		glEnableVertexAttribArray(1);
-
-		// unbind VAO
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	}
-
-	void draw(Shader& shader) {
-		glm::mat4 model = glm::mat4(1.0f);
-		model = glm::translate(model, glm::vec3(position, 0.0f));
-		model = glm::scale(model, glm::vec3(scale, 1.0f));
-
-		shader.bind();
-		shader.setInt(std::string("ourTexture"), 0);
-		shader.setMatrix4Float("u_model", glm::value_ptr(model));
-		shader.setMatrix4Float("u_projection", glm::value_ptr(projection));
-
-		currentSprite->sheet.bind(0);
-
-		glBindVertexArray(vaoID);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-
-		currentSprite->sheet.unbind();
-		shader.unbind();
-	}
-
-	void updateTextureCoordinates() {
-	   elapsedTime -= (float)currentSprite->frameDuration;
-
-		float offset = currentSprite->currentFrameIndex * (1.0f / (float)currentSprite->numberOfFrames);
-		if (flipped) {
-			vertices[0].texCoord = {offset, 1.0f};  // Top left
-			vertices[1].texCoord = {offset, 0.0f};  // Bottom left
-			vertices[2].texCoord = {offset + (1.0f / (float)currentSprite->numberOfFrames), 0.0f};  // Bottom right
-			vertices[3].texCoord = {offset + (1.0f / (float)currentSprite->numberOfFrames), 1.0f};  // Top right
-		} else {
-			vertices[0].texCoord = {offset + (1.0f / (float)currentSprite->numberOfFrames), 1.0f};  // Top right
-			vertices[1].texCoord = {offset + (1.0f / (float)currentSprite->numberOfFrames), 0.0f};  // Bottom right
-			vertices[2].texCoord = {offset, 0.0f};  // Bottom left
-			vertices[3].texCoord = {offset, 1.0f};  // Top left
-		}
-
-		glBindBuffer(GL_ARRAY_BUFFER, vboID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	}
-
-	void playAnimation(float deltaTime, bool looping = true) {
-		elapsedTime += deltaTime;
-		if (elapsedTime >= currentSprite->frameDuration) {
-			if (looping) {
-				currentSprite->currentFrameIndex = (currentSprite->currentFrameIndex + 1) % currentSprite->numberOfFrames;
-			} 
-			else {
-				currentSprite->currentFrameIndex = std::min(currentSprite->currentFrameIndex + 1, currentSprite->numberOfFrames - 1);
-			}
-			updateTextureCoordinates();
-		}
-	}
-
-	void playAnimationReverse(float deltaTime, bool looping = true) {
-		elapsedTime += deltaTime;
-		if (elapsedTime >= currentSprite->frameDuration) {
-			if (looping) {
-				currentSprite->currentFrameIndex = (currentSprite->currentFrameIndex - 1 + currentSprite->numberOfFrames) % currentSprite->numberOfFrames;
-			} 
-			else {
-				currentSprite->currentFrameIndex = std::max(currentSprite->currentFrameIndex - 1, 0);
-			}
-			updateTextureCoordinates();
-		}
-	}
-
-	void updateState(float deltaTime) {
-		glm::vec2 direction;
-		float nextState;
-
-		stateTimer += deltaTime;
-
-		switch (state) {
-			case AnimationStates::Idle:
-				nextState = getRandomFloat(0.0f, 1.0f);
-				if (stateTimer > getRandomFloat(3.0f, 6.0f)) {
-					if (nextState < 0.2f) {
-						state = AnimationStates::Idle;
-					} 
-					else if (nextState < 0.6f) {
-						state = AnimationStates::Walk;
-					} 
-					else if (nextState < 0.8f) {
-						state = AnimationStates::Run;
-					} 
-					else {
-						state = AnimationStates::Sit;
-					}
-					targetPosition = glm::vec2(getRandomFloat(-5.0f, 5.0f), 0.0f);
-					stateTimer = 0.0f;
-				}
-				break;
-
-			case AnimationStates::Walk:
-				direction = glm::normalize(targetPosition - position);
-				position += direction * (1.0f * 0.5f) * deltaTime;
-				if (direction.x > 0) {
-					flipped = true;
-				}
-				if (direction.x < 0) {
-					flipped = false;
-				}
-				if (glm::distance(position, targetPosition) < 0.1f) {
-					float nextState = getRandomFloat(0.0f, 1.0f);
-					if (nextState < 0.5f) {
-						state = AnimationStates::Idle;
-					} 
-					else if (nextState < 0.7f) {
-						targetPosition = glm::vec2(getRandomFloat(-5.0f, 5.0f), 0.0f);
-						state = AnimationStates::Run;
-					} 
-					else {
-						state = AnimationStates::Sit;
-					}
-					stateTimer = 0.0f;
-				}
-				break;
-
-			case AnimationStates::Run:
-				direction = glm::normalize(targetPosition - position);
-				position += direction * (1.0f * 1.0f) * deltaTime;
-				if (direction.x > 0) {
-					flipped = true;
-				}
-				if (direction.x < 0) {
-					flipped = false;
-				}
-				if (glm::distance(position, targetPosition) < 0.1f) {
-					state = AnimationStates::Walk;
-					targetPosition = glm::vec2(getRandomFloat(-5.0f, 5.0f), 0.0f);
-					stateTimer = 0.0f;
-				}
-				break;
-
-			case AnimationStates::Sit:
-				if (stateTimer > 3.0f) {
-					state = GetUp;
-					stateTimer = 0.0f;
-				}
-				break;
-
-			case AnimationStates::GetUp:
-				if (stateTimer > 0.5f) {
-					state = Idle;
-					stateTimer = 0.0f;
-				}
-				break;   
-		}
-
-		if (state == Walk) {
-			currentSprite = &walk;
-		}
-		if (state == Run) {
-			currentSprite = &run;
-		}
-		if (state == Idle) {
-			currentSprite = &idle;
-		}
-		if (state == Sit) {
-			currentSprite = &sit;
-		}
-		if (state == GetUp) {
-			currentSprite = &sit;
-		}
-
-		if (state == GetUp) {
-			playAnimationReverse(deltaTime, false);
-		} 
-		else {
-			playAnimation(deltaTime, state != Sit);
-		}
-	}
-
-private:
-	Sprite walk;
-	Sprite run;
-	Sprite idle;
-	Sprite sit;
-	Sprite getup;
-
-	Sprite* currentSprite;
-	AnimationStates state;
-	float stateTimer;
-
-	float elapsedTime;
-	bool flipped;
-
-	glm::vec2 position;
-	glm::vec2 scale;
-	glm::vec2 velocity;
-	glm::vec2 targetPosition;
-
-	std::vector<Vertex> vertices;
-	std::vector<unsigned int> indices;
-
-	GLuint vaoID, vboID, eboID;
-};
-
 int main(int argc, char* argv[]) {
 	glfwInit();
 	// window variables
@@ -608,6 +129,9 @@ int main(int argc, char* argv[]) {
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	// Mac os
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#ifdef CAPYBARA_GL_DEBUG
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
 
 	const GLFWvidmode * mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
 
@@ -643,13 +167,81 @@ int main(int argc, char* argv[]) {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	Shader shader(std::string(getResourcePath() + "/res/shader/vert.vert"), std::string(getResourcePath() + "/res/shader/frag.frag"));
+	WorldSettings settings;
+	settings.seed = std::random_device()();
 
 	int numberOfCapybaras = 1;
-	std::vector<Capybara> capies;
+	// pets added at run time up to this never reallocate the population, 0 fits the starting pets
+	int capacity = 0;
+	bool printStats = false;
+	bool alwaysRedraw = false;
+	bool checkAllocations = false;
+	// debug builds report through the KHR_debug callback where the driver has it, polling otherwise
+	GLDebugMode debugMode = GLDebugMode::Callback;
+	std::string behaviorPath = getResourcePath() + "/res/behaviors/capybara.behavior";
+	unsigned threads = 1;
+	// ticks per second, drawing blends positions between ticks so it can stay well under the display rate
+	double simRate = 20.0;
+	// pets stop short behind each other and sometimes follow one another, off by default like in capybara_sim
+	bool social = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--pets" && i + 1 < argc) {
+			numberOfCapybaras = std::max(1, std::atoi(argv[++i]));
+		}
+		if (arg == "--capacity" && i + 1 < argc) {
+			capacity = std::max(0, std::atoi(argv[++i]));
+		}
+		if (arg == "--stats") {
+			printStats = true;
+		}
+		if (arg == "--always-redraw") {
+			alwaysRedraw = true;
+		}
+		if (arg == "--check-allocations") {
+			checkAllocations = true;
+		}
+		if (arg == "--gl-debug" && i + 1 < argc) {
+			std::string value = argv[++i];
+			debugMode = value == "poll" ? GLDebugMode::Poll : value == "off" ? GLDebugMode::Off : GLDebugMode::Callback;
+		}
+		if (arg == "--behavior" && i + 1 < argc) {
+			behaviorPath = argv[++i];
+		}
+		if (arg == "--social") {
+			social = true;
+		}
+		if (arg == "--sim-rate" && i + 1 < argc) {
+			simRate = std::max(1.0, std::atof(argv[++i]));
+		}
+		if (arg == "--threads" && i + 1 < argc) {
+			threads = (unsigned)std::max(0, std::atoi(argv[++i]));
+		}
+	}
+
+	// the bundled description can be edited without rebuilding, the built in capybara stays when it doesn't load
+	settings.behavior.load(behaviorPath);
+	settings.timestep = 1.0 / simRate;
+	settings.social.enabled = social;
+	settings.capacity = (uint32_t)std::max(capacity, numberOfCapybaras);
+	World world(settings);
+
+	// wallboards with thousands of pets step them on several threads, 0 uses every hardware thread
+	JobSystem jobs(threads);
+	if (jobs.getThreadCount() > 1) {
+		world.setJobSystem(&jobs);
+	}
+
+	// each thread's per frame scratch, reset at the top of its loop, sized for the pool's capacity
+	// so spawning up to it never has a frame overflow to the heap
+	FrameArena simArena(world.getScratchBytes());
+	world.setFrameArena(&simArena);
+
+	// sleeps between pet events instead of spinning at the display rate
+	FrameScheduler scheduler;
+
 	for (int i = 0; i < numberOfCapybaras; ++i) {
-		Capybara capy(glm::vec2(getRandomFloat(-5.0f, 5.0f), 0.0f), glm::vec2(0.5f, 0.5f));
-		capies.push_back(capy);
+		world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
 	}
 
 	// aspect ratio
@@ -657,7 +249,16 @@ int main(int argc, char* argv[]) {
 	float orthoWidth = 10.0f; 
 	float orthoHeight = orthoWidth / aspectRatio;
 	projection = glm::ortho(-orthoWidth / 2, orthoWidth / 2, -orthoHeight / 2, orthoHeight / 2, -1.0f, 1.0f);
-	lastFrame = glfwGetTime();
+	// integer nanoseconds, a float of seconds gets too coarse for frame times after days of uptime
+	Clock clock;
+	uint64_t lastFrame = clock.getNanoseconds();
+
+	// only builds with the operator new hook count allocations, see core/Allocations.h
+	if (checkAllocations && !Allocations::isTracking()) {
+		std::cout << "error checking allocations | --check-allocations | Build with ALLOCATION_TRACKING to count them." << std::endl;
+		checkAllocations = false;
+	}
+	uint64_t allocationCheckStart = lastFrame + allocationWarmUpNanoseconds;
 
 	NSWindow* cocoaWindow = glfwGetCocoaWindow(window);
 	if (cocoaWindow)
@@ -693,25 +294,171 @@ int main(int argc, char* argv[]) {
 			
 	statusItem.menu = menu;
 
+	// the render thread owns the GL context from here on, a swap blocked on vsync or a slow draw
+	// no longer holds back stepping, it draws the newest snapshot and skips any it was too slow for
+	TripleBuffer<Frame> frames;
+	std::atomic<bool> running{true};
+	std::string resourcePath = getResourcePath();
+	size_t renderScratchBytes = DamageTracker::getScratchBytes(world.getCapacity());
+	glfwMakeContextCurrent(NULL);
+
+	std::thread renderThread([&]() {
+		glfwMakeContextCurrent(window);
+		Debug::setMode(debugMode, (GLADloadproc)glfwGetProcAddress);
+		{
+			// one quad, atlas and shader however many pets, deleted before the context goes
+			ResourceRegistry resources(resourcePath);
+			SpriteRenderer renderer(resources);
+
+			// the window keeps its last frame in the canvas, only damaged rects are redrawn into it
+			Canvas canvas;
+			FrameArena renderArena(renderScratchBytes);
+			DamageTracker damage;
+			damage.setFrameArena(&renderArena);
+			RenderStats stats;
+			int presents = 0;
+
+			// a present's distance to the one before is this thread's frame time, its deviation the jitter
+			TimingStats frameTimes, latency;
+			uint64_t lastPresent = 0;
+			uint64_t reportStart = clock.getNanoseconds();
+			bool hasFrame = false, drew = false;
+			float blend = 0.0f;
+
+			while (running.load(std::memory_order_acquire)) {
+				renderArena.reset();
+
+				// while pets are between ticks every vsync shows them further along, the swap paces
+				// the loop, otherwise nothing changes until the simulation publishes again
+				if (!(hasFrame && drew && frames.getFront().world.blending && blend < 1.0f)) {
+					frames.wait();
+				}
+				hasFrame |= frames.take();
+				if (!hasFrame) {
+					continue;
+				}
+				const Frame& frame = frames.getFront();
+
+				// the frame's blend was taken when it was published, time has moved on since
+				double sincePublish = (clock.getNanoseconds() - frame.inputNanoseconds) * 1e-9 / frame.world.timestep;
+				blend = std::min(frame.world.blend + (float)sincePublish, 1.0f);
+				RenderView view(frame.world, blend);
+
+				// drawing, only when some pet looks different from what was last presented
+				if (canvas.resize(frame.framebufferWidth, frame.framebufferHeight) || alwaysRedraw) {
+					damage.invalidate();
+				}
+
+				// the swap and the window system may allocate, collecting damage and drawing may not
+				std::optional<NoAllocationScope> noAllocation;
+				if (checkAllocations && clock.getNanoseconds() > allocationCheckStart) {
+					noAllocation.emplace(true);
+				}
+				drew = damage.update(view, projection, frame.framebufferWidth, frame.framebufferHeight);
+				if (drew) {
+					canvas.bind();
+					stats = renderer.draw(view, projection, damage.getRects());
+					// the back buffer's age isn't known through NSOpenGL and the swap takes no damage, so the whole
+					// canvas is copied and the whole window composited, only the redraw follows the damage
+					canvas.present();
+				}
+				noAllocation.reset();
+				if (drew) {
+					glfwSwapBuffers(window);
+
+					// the swap returns once the frame is queued for scan out, close enough to photons
+					uint64_t presented = clock.getNanoseconds();
+					latency.add(presented - frame.inputNanoseconds);
+					if (lastPresent) {
+						frameTimes.add(presented - lastPresent);
+					}
+					lastPresent = presented;
+					++presents;
+				}
+
+				uint64_t now = clock.getNanoseconds();
+				if (printStats && now - reportStart >= reportNanoseconds) {
+					// one write per line so it doesn't interleave with the simulation's
+					std::ostringstream line;
+					line << "render | " << stats.instances << " pets | " << stats.drawCalls << " draw calls | " << stats.submitSeconds * 1000.0 << " ms submit | "
+						<< presents << " presents | " << frameTimes.getDeviation() << " ms jitter | " << latency.getMean() << " ms latency, "
+						<< latency.getMax() << " worst | " << renderArena.getHighWater() / 1024 << " KiB arena high water" << std::endl;
+					std::cout << line.str();
+					presents = 0;
+					frameTimes.reset();
+					latency.reset();
+					reportStart = now;
+				}
+			}
+			canvas.destroy();
+		}
+		glfwMakeContextCurrent(NULL);
+	});
+
+	// an iteration that stepped the world is a simulation frame, its distance to the one before the frame time
+	TimingStats stepTimes;
+	uint64_t lastStep = 0;
+	int publishedWidth = 0, publishedHeight = 0;
+
 	while(!glfwWindowShouldClose(window)) {
 		if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 			glfwSetWindowShouldClose(window, true);
 
-		currentFrame = glfwGetTime();
-		dt = currentFrame - lastFrame;
+		simArena.reset();
+
+		// events were just handled, what they changed shows in the frame published below
+		uint64_t currentFrame = clock.getNanoseconds();
+
+		// stepping and publishing may not allocate once warmed up, event handling may
+		std::optional<NoAllocationScope> noAllocation;
+		if (checkAllocations && currentFrame > allocationCheckStart) {
+			noAllocation.emplace(true);
+		}
+
+		// simulation, after the machine slept the missed ticks are caught up in at most maxStepsPerUpdate
+		// multi-tick steps, so waking costs one bounded frame however long it slept or however many pets
+		// there are, advance would walk every pet through every transition it missed
+		bool stepped = world.stepNanoseconds(currentFrame - lastFrame) > 0;
 		lastFrame = currentFrame;
+		if (stepped) {
+			if (lastStep) {
+				stepTimes.add(currentFrame - lastStep);
+			}
+			lastStep = currentFrame;
+		}
 
-		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// a snapshot for the render thread whenever pets or the window may look different
+		int framebufferWidth, framebufferHeight;
+		glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+		if (stepped || alwaysRedraw || framebufferWidth != publishedWidth || framebufferHeight != publishedHeight) {
+			Frame& frame = frames.getBack();
+			frame.world.capture(world);
+			frame.framebufferWidth = framebufferWidth;
+			frame.framebufferHeight = framebufferHeight;
+			frame.inputNanoseconds = currentFrame;
+			frames.publish();
+			publishedWidth = framebufferWidth;
+			publishedHeight = framebufferHeight;
+		}
+		noAllocation.reset();
 
-		// drawing
-		for (int i = 0; i < capies.size(); ++i) {
-			capies[i].updateState(dt);
-			capies[i].draw(shader);
+		// block until some pet has something new to show, menu clicks and other events end the wait early
+		double wait = alwaysRedraw ? 0.0 : scheduler.getWaitTime(world);
+		if (wait > 0.0) {
+			glfwWaitEventsTimeout(wait);
+		}
+		else {
+			glfwPollEvents();
 		}
 
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+		if (scheduler.wokeUp(clock.getSeconds()) && printStats) {
+			const SchedulerStats& schedulerStats = scheduler.getStats();
+			std::ostringstream line;
+			line << "sim | " << world.size() << " pets | " << stepTimes.getDeviation() << " ms jitter | " << stepTimes.getMax() << " ms longest step gap | "
+				<< schedulerStats.wakeupsPerSecond << " wakeups/s | " << schedulerStats.cpuPercent << "% cpu | " << simArena.getHighWater() / 1024 << " KiB arena high water" << std::endl;
+			std::cout << line.str();
+			stepTimes.reset();
+		}
 
 		if (allDesktops) {
 			cocoaWindow.collectionBehavior |= NSWindowCollectionBehaviorCanJoinAllSpaces;
@@ -720,7 +467,10 @@ int main(int argc, char* argv[]) {
 			cocoaWindow.collectionBehavior &= ~NSWindowCollectionBehaviorCanJoinAllSpaces;
 		}
 	}
-	
+
+	running.store(false, std::memory_order_release);
+	frames.wake();
+	renderThread.join();
 	glfwTerminate();
 	return 0;
 }
\ No newline at end of file
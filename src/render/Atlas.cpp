@@ -0,0 +1,110 @@
+#include "render/Atlas.h"
+
+// std
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+	const char magic[4] = {'C', 'A', 'P', 'A'};
+
+	template<typename T>
+	bool readArray(std::ifstream& file, std::vector<T>& values, size_t count) {
+		values.resize(count);
+		file.read((char*)values.data(), count * sizeof(T));
+		return (bool)file;
+	}
+
+	template<typename T>
+	void writeArray(std::ofstream& file, const std::vector<T>& values) {
+		file.write((const char*)values.data(), values.size() * sizeof(T));
+	}
+}
+
+uint32_t Atlas::getSheetFirstFrame(size_t sheet) const {
+	uint32_t first = 0;
+	for (size_t i = 0; i < sheet && i < sheetFrameCounts.size(); ++i) {
+		first += sheetFrameCounts[i];
+	}
+	return first;
+}
+
+bool Atlas::load(const std::string& path) {
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		std::cout << "error reading | " << path << " | Maybe the atlas wasn't baked." << std::endl;
+		return false;
+	}
+
+	char fileMagic[4];
+	uint32_t header[5];
+	file.read(fileMagic, sizeof(fileMagic));
+	file.read((char*)header, sizeof(header));
+	if (!file || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 || header[0] != version) {
+		std::cout << "error reading | " << path << " | Not a version " << version << " atlas." << std::endl;
+		return false;
+	}
+
+	width = header[1];
+	height = header[2];
+	uint32_t rectCount = header[3];
+	uint32_t sheetCount = header[4];
+
+	// the counts decide how much is read, a truncated or stale file must not size anything past its end
+	file.seekg(0, std::ios::end);
+	uint64_t fileSize = (uint64_t)file.tellg();
+	file.seekg(sizeof(fileMagic) + sizeof(header));
+	uint64_t headerBytes = sizeof(fileMagic) + sizeof(header);
+	uint64_t pixelBytes = (uint64_t)width * height * 4;
+	if (headerBytes + (uint64_t)sheetCount * sizeof(uint32_t) + (uint64_t)rectCount * sizeof(AtlasRect) + pixelBytes > fileSize) {
+		std::cout << "error reading | " << path << " | The atlas is shorter than its header says." << std::endl;
+		return false;
+	}
+	if (!readArray(file, sheetFrameCounts, sheetCount)) {
+		return false;
+	}
+
+	uint64_t frameCount = 0;
+	for (uint32_t frames : sheetFrameCounts) {
+		frameCount += frames;
+	}
+	if (headerBytes + ((uint64_t)sheetCount + frameCount) * sizeof(uint32_t) + (uint64_t)rectCount * sizeof(AtlasRect) + pixelBytes != fileSize) {
+		std::cout << "error reading | " << path << " | The atlas size doesn't match its frame counts." << std::endl;
+		return false;
+	}
+	if (!readArray(file, frameRects, frameCount) || !readArray(file, rects, rectCount)) {
+		return false;
+	}
+
+	// everything drawing looks up has to land in the arrays and the image
+	for (uint32_t rectIndex : frameRects) {
+		if (rectIndex >= rects.size()) {
+			std::cout << "error reading | " << path << " | Frame rect " << rectIndex << " is past the " << rects.size() << " rects." << std::endl;
+			return false;
+		}
+	}
+	for (const AtlasRect& rect : rects) {
+		if ((uint32_t)rect.x + rect.width > width || (uint32_t)rect.y + rect.height > height) {
+			std::cout << "error reading | " << path << " | A rect lies outside the " << width << "x" << height << " image." << std::endl;
+			return false;
+		}
+	}
+	return readArray(file, pixels, pixelBytes);
+}
+
+bool Atlas::save(const std::string& path) const {
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cout << "error writing | " << path << std::endl;
+		return false;
+	}
+
+	uint32_t header[5] = {version, width, height, (uint32_t)rects.size(), (uint32_t)sheetFrameCounts.size()};
+	file.write(magic, sizeof(magic));
+	file.write((const char*)header, sizeof(header));
+	writeArray(file, sheetFrameCounts);
+	writeArray(file, frameRects);
+	writeArray(file, rects);
+	writeArray(file, pixels);
+	return (bool)file;
+}
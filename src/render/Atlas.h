@@ -0,0 +1,35 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// pixel rectangle of one unique frame in the atlas, origin bottom left like OpenGL
+struct AtlasRect {
+	uint16_t x, y, width, height;
+};
+
+// every sprite sheet packed into one RGBA image with identical frames stored once
+// baked by atlas_baker at build time, file layout:
+//   "CAPA", version, width, height, rect count, sheet count   (uint32 each)
+//   frame count per sheet                                      (uint32 x sheet count)
+//   rect index per sheet frame, sheets back to back            (uint32 x total frames)
+//   rects                                                      (AtlasRect x rect count)
+//   pixels, bottom row first                                   (RGBA8 x width x height)
+struct Atlas {
+	static constexpr uint32_t version = 1;
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint32_t> sheetFrameCounts;
+	std::vector<uint32_t> frameRects;
+	std::vector<AtlasRect> rects;
+	std::vector<unsigned char> pixels;
+
+	// index into frameRects of the first frame of a sheet
+	uint32_t getSheetFirstFrame(size_t sheet) const;
+
+	bool load(const std::string& path);
+	bool save(const std::string& path) const;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// render
+#include "render/DamageTracker.h"
+#include "render/Debug.h"
+#include "render/GLObject.h"
+#include "render/Texture.h"
+
+// std
+#include <algorithm>
+#include <span>
+
+// offscreen color target that keeps its pixels between frames, the swap chain's back buffers
+// don't, so damaged rects are redrawn here and copied out before each swap, all of the canvas
+// unless the target says which earlier frame it still holds, see present
+class Canvas {
+public:
+	Canvas() : width(0), height(0) {}
+
+	// returns true when the canvas was (re)created and its contents are undefined
+	bool resize(int width, int height) {
+		if (framebuffer && width == this->width && height == this->height) {
+			return false;
+		}
+		destroy();
+		this->width = width;
+		this->height = height;
+		presentedCount = 0;
+
+		colorTexture = Texture(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+		framebuffer = GLFramebuffer::create();
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture.getID(), 0);
+		Debug::checkOpenGLError();
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		return true;
+	}
+
+	void bind() {
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+		glViewport(0, 0, width, height);
+	}
+
+	// copies the canvas into target, the window's default framebuffer unless given
+	void present(GLuint target = 0) {
+		DamageRect all = {0, 0, width, height};
+		present({&all, 1}, 0, target);
+	}
+
+	// copies what changed since target last held a frame, the bounds of this frame's damage and of
+	// the frames presented after that one, age is how many presents ago it was, the way
+	// EGL_EXT_buffer_age counts, 1 for a target that keeps its pixels, 0 when unknown copies everything
+	// returns the rect copied
+	DamageRect present(std::span<const DamageRect> damage, int age, GLuint target = 0) {
+		DamageRect bounds = {width, height, 0, 0};
+		for (const DamageRect& rect : damage) {
+			bounds = unite(bounds, rect);
+		}
+		DamageRect copied = bounds;
+		if (age <= 0 || age > presentedCount + 1) {
+			copied = DamageRect{0, 0, width, height};
+		}
+		for (int i = 0; i + 1 < age && i < presentedCount; ++i) {
+			copied = unite(copied, presented[i]);
+		}
+
+		// newest first, a frame's own damage is what later presents have to copy for it
+		for (int i = std::min(presentedCount, maxBufferAge - 1); i > 0; --i) {
+			presented[i] = presented[i - 1];
+		}
+		presented[0] = bounds;
+		presentedCount = std::min(presentedCount + 1, maxBufferAge);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.get());
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+		if (copied.x1 > copied.x0 && copied.y1 > copied.y0) {
+			glBlitFramebuffer(copied.x0, copied.y0, copied.x1, copied.y1, copied.x0, copied.y0, copied.x1, copied.y1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, target);
+		return copied;
+	}
+
+	void destroy() {
+		framebuffer.reset();
+		colorTexture.destroy();
+	}
+
+	GLuint getFramebufferID() const { return framebuffer.get(); }
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+private:
+	// swap chains keep at most three buffers, an older age copies everything
+	static constexpr int maxBufferAge = 3;
+
+	static DamageRect unite(const DamageRect& a, const DamageRect& b) {
+		return {std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+	}
+
+	Texture colorTexture;
+	GLFramebuffer framebuffer;
+	int width, height;
+
+	// bounds damaged by the last presents, newest first
+	DamageRect presented[maxBufferAge];
+	int presentedCount = 0;
+};
@@ -0,0 +1,186 @@
+#include "render/DamageTracker.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	// each rect is one scissored clear and draw, past this many neighbours get merged
+	constexpr size_t maxDamageRects = 8;
+
+	// pixels redrawn in about the time one more pet is submitted, every rect submits every pet and
+	// their vertices are shaded whether or not they land in the scissor, measured under llvmpipe
+	constexpr double instancePixels = 80.0;
+
+	// rects closer than this are cheaper to redraw as one
+	constexpr int mergeDistance = 16;
+
+	// past this share of the window a single full redraw is cheaper than the scissored ones
+	constexpr float fullFrameShare = 0.5f;
+
+	// covers sprite edges that land between pixels
+	constexpr int boundsPadding = 1;
+
+	DamageRect unite(const DamageRect& a, const DamageRect& b) {
+		return {std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+	}
+}
+
+bool DamageTracker::update(const RenderView& view, const glm::mat4& projection, int width, int height) {
+	size_t count = view.size();
+
+	size_t presentedCount = presentedBounds.size();
+	// at most a rect per pet shown now or before, or the one covering the window
+	FrameArena* arena = frameArena;
+	if (!arena) {
+		scratch.reset();
+		arena = &scratch;
+	}
+	rects = arena->allocateArray<DamageRect>(std::max<size_t>(std::max(count, presentedCount), 1));
+	rectCount = 0;
+	fullFrame = !valid || width != this->width || height != this->height;
+	this->width = width;
+	this->height = height;
+
+	// despawned pets leave their last bounds behind, a despawn moves the last pet into the freed index,
+	// which then differs from what was presented there like any other change
+	if (!fullFrame) {
+		for (size_t i = count; i < presentedCount; ++i) {
+			addDamage(presentedBounds[i]);
+		}
+	}
+	presentedTransform.resize(count);
+	presentedBounds.resize(count);
+	presentedFrame.resize(count);
+	presentedFlipped.resize(count);
+
+	// pixels of pets summed over the window, how many deep they stand on average
+	double coveredPixels = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		// sampled the way SpriteRenderer::getShaderTime has the shader do it
+		const Animation& animation = getAnimation(view.getState(i));
+		uint8_t frameID = (uint8_t)(animation.sheet * 16 + view.getFrameIndex(i));
+		glm::vec4 transform(view.getPosition(i), view.getScale(i));
+		uint8_t flipped = view.isFlipped(i);
+
+		if (!fullFrame && i < presentedCount && frameID == presentedFrame[i] && flipped == presentedFlipped[i] && transform == presentedTransform[i]) {
+			coveredPixels += presentedBounds[i].getArea();
+			continue;
+		}
+		DamageRect bounds = getBounds(view, i, projection);
+		coveredPixels += bounds.getArea();
+		if (!fullFrame) {
+			// spawned pets had nothing on screen
+			addDamage(i < presentedCount ? unite(presentedBounds[i], bounds) : bounds);
+		}
+		presentedTransform[i] = transform;
+		presentedBounds[i] = bounds;
+		presentedFrame[i] = frameID;
+		presentedFlipped[i] = flipped;
+	}
+	valid = true;
+
+	// every rect is a pass over every pet, so past the cost of one full redraw, however small the
+	// rects, the frame is redrawn whole
+	double depth = coveredPixels / std::max(width * height, 1);
+	double passPixels = count * instancePixels;
+	fullRedrawCost = passPixels + (double)width * height * (1.0 + depth);
+	if (!fullFrame) {
+		mergeRects(count, depth);
+		redrawCost = rectCount * passPixels + getDamagedArea() * (1.0 + depth);
+		fullFrame = getDamagedArea() > fullFrameShare * width * height || redrawCost > fullRedrawCost;
+	}
+	if (fullFrame) {
+		rects[0] = DamageRect{0, 0, width, height};
+		rectCount = 1;
+		redrawCost = fullRedrawCost;
+	}
+	return rectCount > 0;
+}
+
+int DamageTracker::getDamagedArea() const {
+	int area = 0;
+	for (const DamageRect& rect : getRects()) {
+		area += rect.getArea();
+	}
+	return area;
+}
+
+// pixel rect the pet's quad covers, the quad spans -0.5 to 0.5 scaled around the position
+DamageRect DamageTracker::getBounds(const RenderView& view, size_t index, const glm::mat4& projection) const {
+	glm::vec2 position = view.getPosition(index);
+	glm::vec2 extent = 0.5f * glm::abs(view.getScale(index));
+	glm::vec4 a = projection * glm::vec4(position - extent, 0.0f, 1.0f);
+	glm::vec4 b = projection * glm::vec4(position + extent, 0.0f, 1.0f);
+
+	// normalized device coordinates to window pixels
+	glm::vec2 low = (glm::min(glm::vec2(a), glm::vec2(b)) * 0.5f + 0.5f) * glm::vec2(width, height);
+	glm::vec2 high = (glm::max(glm::vec2(a), glm::vec2(b)) * 0.5f + 0.5f) * glm::vec2(width, height);
+	DamageRect rect = {
+		(int)std::floor(low.x) - boundsPadding,
+		(int)std::floor(low.y) - boundsPadding,
+		(int)std::ceil(high.x) + boundsPadding,
+		(int)std::ceil(high.y) + boundsPadding
+	};
+
+	rect.x0 = std::clamp(rect.x0, 0, width);
+	rect.y0 = std::clamp(rect.y0, 0, height);
+	rect.x1 = std::clamp(rect.x1, 0, width);
+	rect.y1 = std::clamp(rect.y1, 0, height);
+	return rect;
+}
+
+void DamageTracker::addDamage(const DamageRect& rect) {
+	if (rect.x1 > rect.x0 && rect.y1 > rect.y0) {
+		rects[rectCount++] = rect;
+	}
+}
+
+// the window is a wide strip, so rects are merged along x: overlapping and close ones first,
+// then the closest neighbours until few enough remain, then neighbours whose gap costs less to
+// redraw than another pass over every pet
+void DamageTracker::mergeRects(size_t pets, double depth) {
+	if (rectCount == 0) {
+		return;
+	}
+	std::sort(rects.begin(), rects.begin() + rectCount, [](const DamageRect& a, const DamageRect& b) { return a.x0 < b.x0; });
+
+	size_t merged = 0;
+	for (size_t i = 1; i < rectCount; ++i) {
+		if (rects[i].x0 - rects[merged].x1 <= mergeDistance) {
+			rects[merged] = unite(rects[merged], rects[i]);
+		}
+		else {
+			rects[++merged] = rects[i];
+		}
+	}
+	rectCount = merged + 1;
+
+	while (rectCount > maxDamageRects) {
+		size_t closest = 0;
+		for (size_t i = 1; i + 1 < rectCount; ++i) {
+			if (rects[i + 1].x0 - rects[i].x1 < rects[closest + 1].x0 - rects[closest].x1) {
+				closest = i;
+			}
+		}
+		rects[closest] = unite(rects[closest], rects[closest + 1]);
+		std::copy(rects.begin() + closest + 2, rects.begin() + rectCount, rects.begin() + closest + 1);
+		--rectCount;
+	}
+
+	// the pixels a merge adds are cleared and drawn as deep as pets stand there on average, which
+	// in a crowd costs more than the pass it saves
+	double passPixels = pets * instancePixels;
+	merged = 0;
+	for (size_t i = 1; i < rectCount; ++i) {
+		DamageRect bounds = unite(rects[merged], rects[i]);
+		double added = (double)bounds.getArea() - rects[merged].getArea() - rects[i].getArea();
+		if (added * (1.0 + depth) < passPixels) {
+			rects[merged] = bounds;
+		}
+		else {
+			rects[++merged] = rects[i];
+		}
+	}
+	rectCount = merged + 1;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// glm
+#include <glm/glm.hpp>
+
+// core
+#include "core/FrameArena.h"
+#include "core/Snapshot.h"
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// window pixels [x0, x1) x [y0, y1), origin at the bottom left like glScissor
+struct DamageRect {
+	int x0, y0, x1, y1;
+
+	int getWidth() const { return x1 - x0; }
+	int getHeight() const { return y1 - y0; }
+	int getArea() const { return getWidth() * getHeight(); }
+};
+
+// remembers what every pet looked like when the window was last presented, so a frame where
+// no pet moved, flipped or changed animation frame is skipped and the rest only redraw what changed
+class DamageTracker {
+public:
+	// compares the pets against the last present and collects the damaged rects,
+	// returns false when nothing on screen would change
+	bool update(const RenderView& view, const glm::mat4& projection, int width, int height);
+
+	// the next update damages the whole window, e.g. after the window was resized or exposed
+	void invalidate() { valid = false; }
+
+	// takes the rects from the caller's frame arena, nullptr uses one of the tracker's own, the rects
+	// then last until the arena is reset, so the frame's draw has to come before that
+	void setFrameArena(FrameArena* arena) { frameArena = arena; }
+	// most arena bytes an update takes with this many pets
+	static size_t getScratchBytes(size_t pets) { return sizeof(DamageRect) * std::max<size_t>(pets, 1) + alignof(DamageRect); }
+
+	std::span<const DamageRect> getRects() const { return rects.first(rectCount); }
+	int getDamagedArea() const;
+	bool isFullFrame() const { return fullFrame; }
+
+	// estimated cost of redrawing the rects and of redrawing the whole window, in pixels filled with
+	// every pet a pass submits counted as a few more, update never leaves rects costing more than the window
+	double getRedrawCost() const { return rectCount > 0 ? redrawCost : 0.0; }
+	double getFullRedrawCost() const { return fullRedrawCost; }
+
+private:
+	DamageRect getBounds(const RenderView& view, size_t index, const glm::mat4& projection) const;
+	void addDamage(const DamageRect& rect);
+	void mergeRects(size_t pets, double depth);
+
+	bool valid = false;
+	bool fullFrame = false;
+	int width = 0, height = 0;
+	double redrawCost = 0.0;
+	double fullRedrawCost = 0.0;
+
+	// what was presented, one entry per pet in population order
+	std::vector<glm::vec4> presentedTransform; // xy position, zw scale, subpixel moves still change sampling
+	std::vector<DamageRect> presentedBounds;
+	std::vector<uint8_t> presentedFrame; // frame index into the atlas
+	std::vector<uint8_t> presentedFlipped;
+
+	// room for a rect per pet shown now or before, the first rectCount are this update's
+	std::span<DamageRect> rects;
+	size_t rectCount = 0;
+	FrameArena* frameArena = nullptr;
+	FrameArena scratch; // used without a frame arena
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// std
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// KHR_debug is not part of the 3.3 core profile glad was generated for
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_SOURCE_API 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM 0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY 0x8249
+#define GL_DEBUG_SOURCE_APPLICATION 0x824A
+#define GL_DEBUG_SOURCE_OTHER 0x824B
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+// how OpenGL errors are caught, only debug builds (CAPYBARA_GL_DEBUG) ever check
+enum class GLDebugMode {
+	Off,      // nothing is checked
+	Poll,     // glGetError after every texture bind and uniform set, throws on error
+	Callback  // the driver reports through a KHR_debug message callback, nothing is polled
+};
+
+class Debug {
+public:
+	// compiles to nothing in release builds so the draw path never waits on the driver
+	static void checkOpenGLError() {
+#ifdef CAPYBARA_GL_DEBUG
+		if (mode != GLDebugMode::Poll) {
+			return;
+		}
+		GLenum error = glGetError();
+		if (error != GL_NO_ERROR) {
+			throw std::runtime_error("OpenGL error occurred: " + std::to_string(error));
+		}
+#endif
+	}
+
+	// switches mode on the current context, Callback falls back to Poll without KHR_debug (e.g. macOS)
+	// messages below minimumSeverity or not from source (GL_DONT_CARE for all) are filtered by the driver
+	static GLDebugMode setMode([[maybe_unused]] GLDebugMode newMode, [[maybe_unused]] GLADloadproc load,
+			[[maybe_unused]] GLenum minimumSeverity = GL_DEBUG_SEVERITY_MEDIUM, [[maybe_unused]] GLenum source = GL_DONT_CARE) {
+#ifdef CAPYBARA_GL_DEBUG
+		if (mode == GLDebugMode::Callback && newMode != GLDebugMode::Callback) {
+			glDisable(GL_DEBUG_OUTPUT);
+		}
+		mode = newMode;
+		if (newMode == GLDebugMode::Callback && !installCallback(load, minimumSeverity, source)) {
+			std::cout << "KHR_debug is not available, polling glGetError instead" << std::endl;
+			mode = GLDebugMode::Poll;
+		}
+#endif
+		return mode;
+	}
+
+	static GLDebugMode getMode() { return mode; }
+
+	// messages the callback has reported since startup
+	static unsigned int getMessageCount() { return messageCount; }
+
+	static const char* getModeName(GLDebugMode mode) {
+		switch (mode) {
+			case GLDebugMode::Off: return "off";
+			case GLDebugMode::Poll: return "poll";
+			case GLDebugMode::Callback: return "callback";
+		}
+		return "unknown";
+	}
+
+private:
+	typedef void (APIENTRYP DebugMessageCallbackProc)(GLDEBUGPROC callback, const void* userParam);
+	typedef void (APIENTRYP DebugMessageControlProc)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+
+#ifdef CAPYBARA_GL_DEBUG
+	inline static GLDebugMode mode = GLDebugMode::Poll;
+#else
+	inline static GLDebugMode mode = GLDebugMode::Off;
+#endif
+	inline static unsigned int messageCount = 0;
+
+	static bool hasExtension(const char* name) {
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i) {
+			const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			if (extension && std::strcmp(extension, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool installCallback(GLADloadproc load, GLenum minimumSeverity, GLenum source) {
+		if (!load || !(hasExtension("GL_KHR_debug") || hasExtension("GL_ARB_debug_output"))) {
+			return false;
+		}
+		// the core names are what KHR_debug exports, ARB_debug_output only has the suffixed ones
+		auto messageCallback = (DebugMessageCallbackProc)load("glDebugMessageCallback");
+		auto messageControl = (DebugMessageControlProc)load("glDebugMessageControl");
+		if (!messageCallback || !messageControl) {
+			messageCallback = (DebugMessageCallbackProc)load("glDebugMessageCallbackARB");
+			messageControl = (DebugMessageControlProc)load("glDebugMessageControlARB");
+		}
+		if (!messageCallback || !messageControl) {
+			return false;
+		}
+
+		glEnable(GL_DEBUG_OUTPUT);
+		// errors are reported on the call that caused them, so a breakpoint in the callback has the stack
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		messageCallback(onMessage, nullptr);
+
+		// everything off, then back on from the least severe level wanted up to high
+		messageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+		const GLenum severities[] = {GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION};
+		for (GLenum severity : severities) {
+			messageControl(source, GL_DONT_CARE, severity, 0, nullptr, GL_TRUE);
+			if (severity == minimumSeverity) {
+				break;
+			}
+		}
+		return true;
+	}
+
+	static const char* getSourceName(GLenum source) {
+		switch (source) {
+			case GL_DEBUG_SOURCE_API: return "api";
+			case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+			case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+			case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+			case GL_DEBUG_SOURCE_APPLICATION: return "application";
+		}
+		return "other";
+	}
+
+	static const char* getSeverityName(GLenum severity) {
+		switch (severity) {
+			case GL_DEBUG_SEVERITY_HIGH: return "high";
+			case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+			case GL_DEBUG_SEVERITY_LOW: return "low";
+		}
+		return "notification";
+	}
+
+	// called by the driver, possibly from inside any gl call, so it only reports and never throws
+	static void APIENTRY onMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei, const GLchar* message, const void*) {
+		++messageCount;
+		std::cout << "OpenGL " << (type == GL_DEBUG_TYPE_ERROR ? "error" : "message")
+			<< " (" << getSourceName(source) << ", " << getSeverityName(severity) << ", " << id << "): "
+			<< message << std::endl;
+	}
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// std
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// owns one GL object name and deletes it when it goes, move only so a copy can never delete it twice
+// or leave a dangling name, must be destroyed with its context current on this thread
+template<typename Kind>
+class GLObject {
+public:
+	GLObject() = default;
+	~GLObject() { reset(); }
+
+	GLObject(GLObject&& other) noexcept : id(std::exchange(other.id, 0)) {}
+	GLObject& operator=(GLObject&& other) noexcept {
+		if (this != &other) {
+			reset();
+			id = std::exchange(other.id, 0);
+		}
+		return *this;
+	}
+	GLObject(const GLObject&) = delete;
+	GLObject& operator=(const GLObject&) = delete;
+
+	static GLObject create() {
+		GLObject object;
+		object.id = Kind::create();
+		if (object.id) {
+			++liveCount;
+		}
+		return object;
+	}
+
+	void reset() {
+		if (id) {
+			Kind::destroy(id);
+			id = 0;
+			--liveCount;
+		}
+	}
+
+	GLuint get() const { return id; }
+	explicit operator bool() const { return id != 0; }
+
+	// objects of this kind alive across every context, what a leak check compares
+	static size_t getLiveCount() { return liveCount; }
+
+private:
+	GLuint id = 0;
+	static inline std::atomic<size_t> liveCount = 0;
+};
+
+struct GLTextureKind {
+	static GLuint create() { GLuint id = 0; glGenTextures(1, &id); return id; }
+	static void destroy(GLuint id) { glDeleteTextures(1, &id); }
+};
+
+struct GLBufferKind {
+	static GLuint create() { GLuint id = 0; glGenBuffers(1, &id); return id; }
+	static void destroy(GLuint id) { glDeleteBuffers(1, &id); }
+};
+
+struct GLVertexArrayKind {
+	static GLuint create() { GLuint id = 0; glGenVertexArrays(1, &id); return id; }
+	static void destroy(GLuint id) { glDeleteVertexArrays(1, &id); }
+};
+
+struct GLFramebufferKind {
+	static GLuint create() { GLuint id = 0; glGenFramebuffers(1, &id); return id; }
+	static void destroy(GLuint id) { glDeleteFramebuffers(1, &id); }
+};
+
+struct GLProgramKind {
+	static GLuint create() { return glCreateProgram(); }
+	static void destroy(GLuint id) { glDeleteProgram(id); }
+};
+
+using GLTexture = GLObject<GLTextureKind>;
+using GLBuffer = GLObject<GLBufferKind>;
+using GLVertexArray = GLObject<GLVertexArrayKind>;
+using GLFramebuffer = GLObject<GLFramebufferKind>;
+using GLProgram = GLObject<GLProgramKind>;
+
+// every GL object the wrappers own right now
+inline size_t getLiveGLObjectCount() {
+	return GLTexture::getLiveCount() + GLBuffer::getLiveCount() + GLVertexArray::getLiveCount()
+		+ GLFramebuffer::getLiveCount() + GLProgram::getLiveCount();
+}
@@ -0,0 +1,87 @@
+#include "render/ResourceRegistry.h"
+
+// glm
+#include <glm/glm.hpp>
+
+// std
+#include <cstddef>
+
+namespace {
+	struct QuadVertex {
+		glm::vec3 position;
+		glm::vec2 texCoord; // x is 0 on the left edge and 1 on the right, the shader picks the frame
+	};
+
+	const QuadVertex quadVertices[] = {
+		{{ 0.5f,  0.5f, 0.0f}, {1.0f, 1.0f}},
+		{{ 0.5f, -0.5f, 0.0f}, {1.0f, 0.0f}},
+		{{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f}},
+		{{-0.5f,  0.5f, 0.0f}, {0.0f, 1.0f}}
+	};
+	const unsigned int quadIndices[Quad::indexCount] = {
+		0, 1, 3,
+		1, 2, 3
+	};
+}
+
+void Quad::attach() const {
+	glBindBuffer(GL_ARRAY_BUFFER, vertices.get());
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.get());
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), (void*)offsetof(QuadVertex, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), (void*)offsetof(QuadVertex, texCoord));
+	glEnableVertexAttribArray(1);
+}
+
+ResourceRegistry::ResourceRegistry(const std::string& resourcePath) : resourcePath(resourcePath) {}
+
+const Quad& ResourceRegistry::getQuad() {
+	if (!quad) {
+		quad = std::make_unique<Quad>();
+		quad->vertices = GLBuffer::create();
+		glBindBuffer(GL_ARRAY_BUFFER, quad->vertices.get());
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		// element buffers bind to the current vertex array, so this one is filled through the array target
+		quad->indices = GLBuffer::create();
+		glBindBuffer(GL_ARRAY_BUFFER, quad->indices.get());
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	return *quad;
+}
+
+const Texture& ResourceRegistry::getTexture(const std::string& path) {
+	auto found = textures.find(path);
+	if (found == textures.end()) {
+		found = textures.emplace(path, Texture(resourcePath + "/" + path)).first;
+	}
+	return found->second;
+}
+
+const AtlasTexture& ResourceRegistry::getAtlas(const std::string& path) {
+	auto found = atlases.find(path);
+	if (found != atlases.end()) {
+		return found->second;
+	}
+
+	// one file read and one upload instead of decoding every sheet
+	AtlasTexture& atlas = atlases[path];
+	atlas.loaded = atlas.layout.load(resourcePath + "/" + path);
+	if (atlas.loaded) {
+		atlas.texture = Texture((int)atlas.layout.width, (int)atlas.layout.height, atlas.layout.pixels.data());
+		atlas.layout.pixels = std::vector<unsigned char>();
+	}
+	return atlas;
+}
+
+Shader& ResourceRegistry::getShader(const std::string& vertexPath, const std::string& fragmentPath) {
+	std::string key = vertexPath + "|" + fragmentPath;
+	auto found = shaders.find(key);
+	if (found == shaders.end()) {
+		found = shaders.emplace(key, Shader(resourcePath + "/" + vertexPath, resourcePath + "/" + fragmentPath)).first;
+	}
+	return found->second;
+}
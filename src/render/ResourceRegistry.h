@@ -0,0 +1,59 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// render
+#include "render/Atlas.h"
+#include "render/GLObject.h"
+#include "render/Shader.h"
+#include "render/Texture.h"
+
+// std
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// the unit quad every sprite is drawn on, never written after it is created
+struct Quad {
+	static constexpr GLsizei indexCount = 6;
+
+	GLBuffer vertices;
+	GLBuffer indices;
+
+	// points the bound vertex array's attributes 0 (position) and 1 (texture coordinate) and its
+	// element buffer at the quad
+	void attach() const;
+};
+
+// a baked atlas on the GPU, the layout keeps everything but the pixels, which are dropped after upload
+struct AtlasTexture {
+	Texture texture;
+	Atlas layout;
+	bool loaded = false;
+};
+
+// hands out one GL object per asset however many renderers or pets ask for it, created on first
+// use on the thread whose context is current and deleted with the registry, which has to go
+// before the context does
+class ResourceRegistry {
+public:
+	ResourceRegistry(const std::string& resourcePath);
+
+	const Quad& getQuad();
+	// paths are relative to the resource path, e.g. "res/sprites/capybara.atlas"
+	const Texture& getTexture(const std::string& path);
+	const AtlasTexture& getAtlas(const std::string& path);
+	Shader& getShader(const std::string& vertexPath, const std::string& fragmentPath);
+
+	const std::string& getResourcePath() const { return resourcePath; }
+	// textures, atlases and shaders loaded so far, the quad not counted
+	size_t getAssetCount() const { return textures.size() + atlases.size() + shaders.size(); }
+
+private:
+	std::string resourcePath;
+	std::unique_ptr<Quad> quad;
+	std::unordered_map<std::string, Texture> textures;
+	std::unordered_map<std::string, AtlasTexture> atlases;
+	std::unordered_map<std::string, Shader> shaders;
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// glm
+#include <glm/glm.hpp>
+
+// render
+#include "render/Debug.h"
+#include "render/GLObject.h"
+
+// std
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// location of a uniform, typed so setting it picks the right glUniform call at compile time
+template<typename T>
+struct Uniform {
+	GLint location = -1;
+
+	bool isValid() const { return location != -1; }
+};
+
+// an active uniform as reported by the driver after linking, arrays are stored without the [0]
+struct ShaderUniform {
+	std::string name;
+	GLint location;
+	GLenum type;
+	GLint size;
+};
+
+// move only, the program is deleted when the Shader goes, see render/GLObject.h
+class Shader {
+public:
+	Shader() {}
+	Shader(const std::string& vertexFilePath, const std::string& fragmentFilePath) {
+		compile(returnFileContents(vertexFilePath), returnFileContents(fragmentFilePath));
+	}
+
+	void setBool(const std::string& name, bool value) {
+		glUniform1i(getUniformLocation(name), (int)value);
+		Debug::checkOpenGLError();
+	}
+	void setInt(const std::string& name, int value) {
+		glUniform1i(getUniformLocation(name), (int)value);
+		Debug::checkOpenGLError();
+	}
+	void setFloat(const std::string& name, float value) {
+		glUniform1f(getUniformLocation(name), value);
+		Debug::checkOpenGLError();
+	}
+	void setVector2Float(const std::string& name, const float* vec2) {
+		glUniform2fv(getUniformLocation(name), 1, vec2);
+		Debug::checkOpenGLError();
+	}
+	void setVector3Float(const std::string& name, const float* vec3) {
+		glUniform3fv(getUniformLocation(name), 1, vec3);
+		Debug::checkOpenGLError();
+	}
+	void setVector4Float(const std::string& name, const float* vec4) {
+		glUniform4fv(getUniformLocation(name), 1, vec4);
+		Debug::checkOpenGLError();
+	}
+	void setVector4FloatArray(const std::string& name, const float* vec4s, int count) {
+		glUniform4fv(getUniformLocation(name), count, vec4s);
+		Debug::checkOpenGLError();
+	}
+	void setMatrix4Float(const std::string& name, const float* mat4) {
+		glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, mat4);
+		Debug::checkOpenGLError();
+	}
+
+	// looked up once, setting through a handle is a plain glUniform call with no name lookup
+	template<typename T>
+	Uniform<T> getUniform(const std::string& name) const {
+		Uniform<T> uniform;
+		const ShaderUniform* found = findUniform(name);
+		if (!found) {
+			std::cerr << "Warning: Uniform '" << name << "' not found in shader program with ID: " << program.get() << std::endl;
+			return uniform;
+		}
+		if (!typeMatches<T>(found->type)) {
+			std::cerr << "Warning: Uniform '" << name << "' has GL type " << found->type << " which the handle type doesn't match" << std::endl;
+		}
+		uniform.location = found->location;
+		return uniform;
+	}
+
+	// errors are polled like the string setters, which only debug builds do, see Debug::checkOpenGLError
+	void set(Uniform<bool> uniform, bool value) {
+		glUniform1i(uniform.location, (int)value);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<int> uniform, int value) {
+		glUniform1i(uniform.location, value);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<float> uniform, float value) {
+		glUniform1f(uniform.location, value);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<glm::vec2> uniform, const glm::vec2& value) {
+		glUniform2fv(uniform.location, 1, &value[0]);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<glm::vec3> uniform, const glm::vec3& value) {
+		glUniform3fv(uniform.location, 1, &value[0]);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<glm::vec4> uniform, const glm::vec4& value) {
+		glUniform4fv(uniform.location, 1, &value[0]);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<glm::vec4> uniform, const glm::vec4* values, int count) {
+		glUniform4fv(uniform.location, count, &values[0][0]);
+		Debug::checkOpenGLError();
+	}
+	void set(Uniform<glm::mat4> uniform, const glm::mat4& value) {
+		glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &value[0][0]);
+		Debug::checkOpenGLError();
+	}
+
+	const std::vector<ShaderUniform>& getUniforms() const { return uniforms; }
+
+	void bind() { glUseProgram(program.get()); }
+	void unbind() { glUseProgram(0); }
+	void destroy() { program.reset(); }
+
+	GLuint getID() const { return program.get(); }
+
+private:
+	std::string returnFileContents(const std::string& filePath) {
+		std::string contents; // contents for the file
+		std::ifstream file(filePath, std::ios::in);
+
+		// if unable to open file
+		if (!file.is_open()) {
+			std::cout << "error reading | " << filePath << " | Maybe wrong file name." << std::endl;
+			return contents;
+		}
+
+		std::string line = "";
+		while (!file.eof()) {
+			std::getline(file, line);
+			contents.append(line + "\n");
+		}
+
+		file.close();
+		return contents;
+	}
+	void compile(const std::string& vertexContents, const std::string& fragmentContents) {
+		const char* vertexSource = vertexContents.c_str();
+		const char* fragmentSource = fragmentContents.c_str();
+
+		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+
+		// compiling vertex shader
+		glShaderSource(vertexShader, 1, &vertexSource, NULL);
+		glCompileShader(vertexShader);
+
+		// compiling fragment shader
+		glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
+		glCompileShader(fragmentShader);
+
+		// checking both shaders for errors
+		compileErrorChecking(vertexShader);
+		compileErrorChecking(fragmentShader);
+
+		// linking shaders
+		program = GLProgram::create();
+		glAttachShader(program.get(), vertexShader);
+		glAttachShader(program.get(), fragmentShader);
+		glLinkProgram(program.get());
+
+		// deleting shaders
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		reflectUniforms();
+	}
+	void reflectUniforms() {
+		GLint count = 0, maxLength = 0;
+		glGetProgramiv(program.get(), GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(program.get(), GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+		std::vector<GLchar> buffer(maxLength + 1);
+		for (GLint i = 0; i < count; ++i) {
+			ShaderUniform uniform;
+			GLsizei length = 0;
+			glGetActiveUniform(program.get(), (GLuint)i, (GLsizei)buffer.size(), &length, &uniform.size, &uniform.type, buffer.data());
+
+			uniform.name.assign(buffer.data(), length);
+			uniform.location = glGetUniformLocation(program.get(), uniform.name.c_str());
+			if (uniform.name.size() > 3 && uniform.name.compare(uniform.name.size() - 3, 3, "[0]") == 0) {
+				uniform.name.resize(uniform.name.size() - 3);
+			}
+			uniforms.push_back(uniform);
+		}
+	}
+	const ShaderUniform* findUniform(const std::string& name) const {
+		for (const ShaderUniform& uniform : uniforms) {
+			if (uniform.name == name) {
+				return &uniform;
+			}
+		}
+		return nullptr;
+	}
+	template<typename T>
+	static bool typeMatches(GLenum type) {
+		if constexpr (std::is_same_v<T, bool>) return type == GL_BOOL || type == GL_INT;
+		else if constexpr (std::is_same_v<T, int>) return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D;
+		else if constexpr (std::is_same_v<T, float>) return type == GL_FLOAT;
+		else if constexpr (std::is_same_v<T, glm::vec2>) return type == GL_FLOAT_VEC2;
+		else if constexpr (std::is_same_v<T, glm::vec3>) return type == GL_FLOAT_VEC3;
+		else if constexpr (std::is_same_v<T, glm::vec4>) return type == GL_FLOAT_VEC4;
+		else if constexpr (std::is_same_v<T, glm::mat4>) return type == GL_FLOAT_MAT4;
+		else return false;
+	}
+	void compileErrorChecking(const GLuint& shaderID) {
+		GLint compileStatus;
+		glGetShaderiv(shaderID, GL_COMPILE_STATUS, &compileStatus);
+
+		// if there is an error
+		if (compileStatus != GL_TRUE) {
+			GLint infoLogLenth;
+
+			glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &infoLogLenth);
+			GLchar* buffer = new GLchar[infoLogLenth];
+
+			GLsizei bufferSize;
+			glGetShaderInfoLog(shaderID, infoLogLenth, &bufferSize, buffer);
+
+			std::cout << buffer << std::endl;
+
+			delete [ ] buffer;
+		}
+	}
+	GLint getUniformLocation(const std::string& name) {
+		const ShaderUniform* found = findUniform(name);
+		if (found) {
+			return found->location;
+		}
+
+		// array elements past the first aren't in the reflected table
+		GLint location = glGetUniformLocation(program.get(), name.c_str());
+		if (location == -1) {
+			std::cerr << "Warning: Uniform '" << name << "' not found in shader program with ID: " << program.get() << std::endl;
+		}
+		return location;
+	}
+
+	GLProgram program;
+	std::vector<ShaderUniform> uniforms;
+};
@@ -0,0 +1,250 @@
+#include "render/SpriteRenderer.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+namespace {
+	// relative to the registry's resource path
+	const char* const atlasPath = "res/sprites/capybara.atlas";
+	const char* const vertexShaderPath = "res/shader/vert.vert";
+	const char* const fragmentShaderPath = "res/shader/frag.frag";
+
+	// size of u_frames in the vertex shader
+	constexpr size_t maxAtlasFrames = 64;
+
+	// clean slots worth re-sending to save a buffer call
+	constexpr size_t mergeGap = 8;
+
+	// an hour keeps float start times well under a millisecond of error
+	constexpr double epochLength = 3600.0;
+
+	double secondsSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+SpriteRenderer::SpriteRenderer(ResourceRegistry& resources)
+	: shader(resources.getShader(vertexShaderPath, fragmentShaderPath)), atlasTexture(resources.getAtlas(atlasPath).texture),
+	instanceCapacity(0), uploadedTick(0), timeEpoch(0.0) {
+	const AtlasTexture& sharedAtlas = resources.getAtlas(atlasPath);
+	const Atlas& atlas = sharedAtlas.layout;
+	std::vector<glm::vec4> frameRects;
+	if (sharedAtlas.loaded) {
+		for (uint32_t rectIndex : atlas.frameRects) {
+			const AtlasRect& rect = atlas.rects[rectIndex];
+			frameRects.push_back(glm::vec4(rect.x, rect.y, rect.width, rect.height) / glm::vec4(atlas.width, atlas.height, atlas.width, atlas.height));
+		}
+		if (frameRects.size() > maxAtlasFrames) {
+			std::cout << "Warning: atlas has " << frameRects.size() << " frames, only " << maxAtlasFrames << " fit in the shader" << std::endl;
+			frameRects.resize(maxAtlasFrames);
+		}
+	}
+
+	for (int sheet = 0; sheet < numberOfSpriteSheets; ++sheet) {
+		sheetFirstFrame[sheet] = atlas.getSheetFirstFrame(sheet);
+	}
+	for (const Animation& animation : animations) {
+		if (animation.sheet >= (int)atlas.sheetFrameCounts.size() || (int)atlas.sheetFrameCounts[animation.sheet] != animation.numberOfFrames) {
+			std::cout << "Warning: atlas doesn't match the animation table, rebake it" << std::endl;
+			break;
+		}
+	}
+
+	// generate and bind VAO
+	vertexArray = GLVertexArray::create();
+	glBindVertexArray(vertexArray.get());
+
+	// the unit quad every pet and every renderer shares
+	resources.getQuad().attach();
+
+	// per instance attributes
+	instanceBuffer = GLBuffer::create();
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+	for (GLuint attribute = 2; attribute <= 4; ++attribute) {
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+	setInstanceOffset(0);
+
+	// unbind VAO
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	projectionUniform = shader.getUniform<glm::mat4>("u_projection");
+	timeUniform = shader.getUniform<float>("u_time");
+
+	shader.bind();
+	shader.set(shader.getUniform<int>("ourTexture"), 0);
+	if (!frameRects.empty()) {
+		shader.set(shader.getUniform<glm::vec4>("u_frames"), frameRects.data(), (int)frameRects.size());
+	}
+	shader.unbind();
+}
+
+RenderStats SpriteRenderer::draw(const RenderView& view, const glm::mat4& projection) {
+	auto start = std::chrono::steady_clock::now();
+	RenderStats stats;
+
+	updateInstances(view, stats);
+	submit(view, projection, stats);
+
+	stats.instances = instances.size();
+	stats.submitSeconds = secondsSince(start);
+	return stats;
+}
+
+RenderStats SpriteRenderer::draw(const RenderView& view, const glm::mat4& projection, std::span<const DamageRect> damage) {
+	auto start = std::chrono::steady_clock::now();
+	RenderStats stats;
+
+	updateInstances(view, stats);
+
+	// every pet is submitted per rect, the scissor keeps the fill to the damaged pixels
+	glEnable(GL_SCISSOR_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	for (const DamageRect& rect : damage) {
+		glScissor(rect.x0, rect.y0, rect.getWidth(), rect.getHeight());
+		glClear(GL_COLOR_BUFFER_BIT);
+		submit(view, projection, stats);
+	}
+	glDisable(GL_SCISSOR_TEST);
+
+	stats.instances = instances.size();
+	stats.submitSeconds = secondsSince(start);
+	return stats;
+}
+
+void SpriteRenderer::submit(const RenderView& view, const glm::mat4& projection, RenderStats& stats) {
+	if (instances.empty()) {
+		return;
+	}
+
+	shader.bind();
+	shader.set(projectionUniform, projection);
+	shader.set(timeUniform, getShaderTime(view));
+	atlasTexture.bind(0);
+
+	glBindVertexArray(vertexArray.get());
+	glDrawElementsInstanced(GL_TRIANGLES, Quad::indexCount, GL_UNSIGNED_INT, 0, (GLsizei)instances.size());
+	glBindVertexArray(0);
+	++stats.drawCalls;
+
+	atlasTexture.unbind();
+	shader.unbind();
+}
+
+// world time is always a whole tick and frame boundaries land exactly on ticks, so half a tick
+// is added to keep the shader's float floor() away from them and agreeing with World::getStateTime
+float SpriteRenderer::getShaderTime(const RenderView& view) const {
+	return (float)(view.getTime() - timeEpoch + 0.5 * view.getTimestep());
+}
+
+RenderStats SpriteRenderer::drawPerPet(const RenderView& view, const glm::mat4& projection) {
+	auto start = std::chrono::steady_clock::now();
+	RenderStats stats;
+
+	updateInstances(view, stats);
+
+	for (size_t i = 0; i < instances.size(); ++i) {
+		shader.bind();
+		shader.setInt("ourTexture", 0);
+		shader.setMatrix4Float("u_projection", &projection[0][0]);
+		shader.setFloat("u_time", getShaderTime(view));
+		atlasTexture.bind(0);
+
+		glBindVertexArray(vertexArray.get());
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+		setInstanceOffset(i);
+		glDrawElementsInstanced(GL_TRIANGLES, Quad::indexCount, GL_UNSIGNED_INT, 0, 1);
+		setInstanceOffset(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		atlasTexture.unbind();
+		shader.unbind();
+		++stats.drawCalls;
+	}
+
+	stats.instances = instances.size();
+	stats.submitSeconds = secondsSince(start);
+	return stats;
+}
+
+// rewrites only the slots of pets that moved, changed state or were spawned since the last upload,
+// a despawn moves the last pet into the freed slot, so only that one is rewritten
+void SpriteRenderer::updateInstances(const RenderView& view, RenderStats& stats) {
+	size_t count = view.size();
+	size_t uploadedCount = instances.size();
+
+	bool rebuild = view.getTime() - timeEpoch > epochLength;
+	if (rebuild) {
+		timeEpoch = view.getTime();
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+	if (count > instanceCapacity) {
+		instanceCapacity = count * 2;
+		glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_DYNAMIC_DRAW);
+		instances.reserve(instanceCapacity);
+		instanceSlots.reserve(instanceCapacity);
+		rebuild = true;
+	}
+	instances.resize(count);
+	instanceSlots.resize(count);
+
+	// upload runs of dirty slots, runs separated by only a few clean slots are merged into one call
+	size_t runFirst = 0, runLast = 0;
+	// a pet that stopped was last written partway blended, it settles on the tick after its state started
+	for (size_t i = 0; i < count; ++i) {
+		if (!rebuild && i < uploadedCount && view.getSlot(i) == instanceSlots[i] && !view.isMoving(i) && view.getStateStartTick(i) + 1 < uploadedTick) {
+			continue;
+		}
+
+		writeInstance(view, i);
+		instanceSlots[i] = view.getSlot(i);
+		if (runLast > runFirst && i - runLast > mergeGap) {
+			stats.uploadedBytes += uploadRange(runFirst, runLast);
+			runFirst = i;
+		}
+		else if (runLast == runFirst) {
+			runFirst = i;
+		}
+		runLast = i + 1;
+	}
+	if (runLast > runFirst) {
+		stats.uploadedBytes += uploadRange(runFirst, runLast);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	uploadedTick = view.getTickCount();
+}
+
+size_t SpriteRenderer::uploadRange(size_t first, size_t last) {
+	size_t bytes = (last - first) * sizeof(SpriteInstance);
+	glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(SpriteInstance), bytes, instances.data() + first);
+	return bytes;
+}
+
+void SpriteRenderer::writeInstance(const RenderView& view, size_t index) {
+	const Animation& animation = getAnimation(view.getState(index));
+
+	double startTime = view.getStateStartTick(index) * view.getTimestep() - timeEpoch;
+	float firstFrame = animation.reversed ? (float)(animation.numberOfFrames - 1) : 0.0f;
+
+	SpriteInstance& instance = instances[index];
+	instance.transform = glm::vec4(view.getPosition(index), view.getScale(index));
+	instance.animation = glm::vec4((float)startTime, animation.frameDuration, (float)animation.numberOfFrames, firstFrame);
+	instance.playback = glm::vec4(animation.reversed ? -1.0f : 1.0f, animation.looping ? 1.0f : 0.0f, view.isFlipped(index) ? 1.0f : 0.0f, (float)sheetFirstFrame[animation.sheet]);
+}
+
+// GL 3.3 has no base instance, so a single pet is selected by moving the attribute pointers
+void SpriteRenderer::setInstanceOffset(size_t first) {
+	size_t offset = first * sizeof(SpriteInstance);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, transform)));
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, animation)));
+	glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, playback)));
+}
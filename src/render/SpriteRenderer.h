@@ -0,0 +1,84 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// glm
+#include <glm/glm.hpp>
+
+// core
+#include "core/Snapshot.h"
+
+// render
+#include "render/Atlas.h"
+#include "render/DamageTracker.h"
+#include "render/GLObject.h"
+#include "render/ResourceRegistry.h"
+#include "render/Shader.h"
+#include "render/Texture.h"
+
+// std
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// per pet data kept on the GPU, the vertex shader derives the animation frame from it and the time
+struct SpriteInstance {
+	glm::vec4 transform; // xy position, zw scale
+	glm::vec4 animation; // x start time, y frame duration, z frame count, w first frame
+	glm::vec4 playback;  // x frame step, y 1 when looping, z 1 when flipped, w first entry of the sheet in the frame table
+};
+
+struct RenderStats {
+	int drawCalls = 0;
+	size_t instances = 0;
+	size_t uploadedBytes = 0;
+	double submitSeconds = 0.0; // CPU time spent building and submitting the frame
+};
+
+// draws the whole population with one instanced draw, pets only touch the instance buffer
+// when they change state or move, animation frames are picked on the GPU
+// takes a World directly or a WorldSnapshot, e.g. on a render thread, see core/Snapshot.h
+// the quad, atlas and shader come from the registry and are shared with every other renderer,
+// only the vertex array and the instance buffer are its own
+class SpriteRenderer {
+public:
+	SpriteRenderer(ResourceRegistry& resources);
+
+	RenderStats draw(const RenderView& view, const glm::mat4& projection);
+
+	// clears and redraws only inside the damaged rects, the rest of the target keeps the last frame
+	RenderStats draw(const RenderView& view, const glm::mat4& projection, std::span<const DamageRect> damage);
+
+	// submits pets one at a time with a full bind and unbind each, the way pets used to be drawn
+	// only kept as the baseline render_bench compares against
+	RenderStats drawPerPet(const RenderView& view, const glm::mat4& projection);
+
+private:
+	void updateInstances(const RenderView& view, RenderStats& stats);
+	void submit(const RenderView& view, const glm::mat4& projection, RenderStats& stats);
+	float getShaderTime(const RenderView& view) const;
+	void writeInstance(const RenderView& view, size_t index);
+	size_t uploadRange(size_t first, size_t last);
+	void setInstanceOffset(size_t first);
+
+	Shader& shader;
+	Uniform<glm::mat4> projectionUniform;
+	Uniform<float> timeUniform;
+	// every sheet lives in one baked atlas texture, bound once for the whole population
+	const Texture& atlasTexture;
+	uint32_t sheetFirstFrame[numberOfSpriteSheets];
+
+	GLVertexArray vertexArray;
+	GLBuffer instanceBuffer;
+	size_t instanceCapacity;
+
+	// CPU copy of the instance buffer, one slot per pet in population order
+	std::vector<SpriteInstance> instances;
+	std::vector<uint32_t> instanceSlots; // the pet each instance was written for
+	uint64_t uploadedTick;
+
+	// start times are stored relative to this so they keep float precision on long runs
+	double timeEpoch;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+// openGL
+#include <glad/glad.h>
+
+// stb
+#include <stb_image.h>
+
+// render
+#include "render/Debug.h"
+#include "render/GLObject.h"
+
+// std
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// move only, the GL texture is deleted when the Texture goes, see render/GLObject.h
+class Texture {
+public:
+	Texture() : width(0), height(0), nrChannels(0), internalFormat(GL_RGBA), imageFormat(GL_RGBA), pixelType(GL_UNSIGNED_BYTE) {}
+	Texture(const std::string& filename) : filename(filename), pixelType(GL_UNSIGNED_BYTE) {
+		unsigned char* data = loadTexture();
+		setFormat();
+		createOpenGLTexture(data);
+
+		// freeing memory
+		stbi_image_free(data);
+	}
+
+	Texture(int width, int height, GLenum internalFormat, GLenum imageFormat, GLenum pixelType) : width(width), height(height), nrChannels(0), internalFormat(internalFormat), imageFormat(imageFormat), pixelType(pixelType)  {
+		createOpenGLTexture(nullptr);
+	}
+
+	// RGBA8 texture from pixels already in memory, e.g. a baked atlas, the pixels stay the caller's
+	Texture(int width, int height, const unsigned char* pixels) : width(width), height(height), nrChannels(4), internalFormat(GL_RGBA), imageFormat(GL_RGBA), pixelType(GL_UNSIGNED_BYTE) {
+		createOpenGLTexture(pixels);
+	}
+
+	void bind(int slot) const {
+		glActiveTexture(GL_TEXTURE0 + slot);
+		glBindTexture(GL_TEXTURE_2D, texture.get());
+		Debug::checkOpenGLError();
+	}
+	void unbind() const {
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+	void destroy() {
+		texture.reset();
+	}
+
+	GLuint getID() const { return texture.get(); }
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+private:
+	unsigned char* loadTexture() {
+		stbi_set_flip_vertically_on_load(true); // flip the texture
+		unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
+		if (!data) {
+			std::cout << "Failed to load image" << std::endl;
+		}
+		return data;
+	}
+	void setFormat() {
+		switch (nrChannels) {
+			case 1: internalFormat = imageFormat = GL_RED; break;
+			case 2: internalFormat = imageFormat = GL_RG; break;
+			case 3: internalFormat = imageFormat = GL_RGB; break;
+			case 4: internalFormat = imageFormat = GL_RGBA; break;
+			default: throw std::runtime_error("Unsupported image format: " + filename);
+		}
+	}
+	void createOpenGLTexture(const unsigned char* data) {
+		texture = GLTexture::create();
+		Debug::checkOpenGLError();
+		glBindTexture(GL_TEXTURE_2D, texture.get());
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, imageFormat, pixelType, data);
+		Debug::checkOpenGLError();
+
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	std::string filename;
+	GLTexture texture;
+	int width, height, nrChannels;
+	GLenum internalFormat;
+	GLenum imageFormat;
+	GLenum pixelType;
+};
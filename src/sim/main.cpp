@@ -0,0 +1,212 @@
+// headless simulation driver, runs the pet simulation without a window and reports throughput
+
+// core
+#include "core/Allocations.h"
+#include "core/JobSystem.h"
+#include "core/Kernels.h"
+#include "core/Scheduler.h"
+#include "core/World.h"
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+struct Options {
+	size_t pets = 10000;
+	double seconds = 60.0;
+	double frameTime = 1.0 / 60.0;
+	double rate = 60.0;     // simulation ticks per second, independent of the frame time
+	uint32_t seed = 1;
+	bool scheduled = false; // wake only for pet events like the app does, instead of every frame
+	bool social = false;    // pets avoid and follow each other
+	double hitch = 0.0;     // one frame this long at the end, like waking from sleep
+	std::string behavior;   // description file, the built in capybara when empty
+	unsigned threads = 1;   // job system threads, 1 steps on the main thread alone
+	bool checkAllocations = false; // abort on any heap allocation while stepping
+};
+
+void printUsage() {
+	std::cout << "usage: capybara_sim [--pets N] [--seconds S] [--frame-time DT] [--rate HZ] [--seed N] [--scheduled] [--social] [--hitch S] [--behavior FILE] [--threads N] [--check-allocations]" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h") {
+			return false;
+		}
+		if (arg == "--scheduled") {
+			options.scheduled = true;
+			continue;
+		}
+		if (arg == "--social") {
+			options.social = true;
+			continue;
+		}
+		if (arg == "--check-allocations") {
+			options.checkAllocations = true;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			std::cout << "missing value for " << arg << std::endl;
+			return false;
+		}
+
+		const char* value = argv[++i];
+		if (arg == "--pets") {
+			options.pets = std::strtoull(value, nullptr, 10);
+		}
+		else if (arg == "--seconds") {
+			options.seconds = std::strtod(value, nullptr);
+		}
+		else if (arg == "--frame-time") {
+			options.frameTime = std::strtod(value, nullptr);
+		}
+		else if (arg == "--rate") {
+			options.rate = std::strtod(value, nullptr);
+		}
+		else if (arg == "--hitch") {
+			options.hitch = std::strtod(value, nullptr);
+		}
+		else if (arg == "--threads") {
+			options.threads = (unsigned)std::strtoul(value, nullptr, 10);
+		}
+		else if (arg == "--behavior") {
+			options.behavior = value;
+		}
+		else if (arg == "--seed") {
+			options.seed = (uint32_t)std::strtoul(value, nullptr, 10);
+		}
+		else {
+			std::cout << "unknown option " << arg << std::endl;
+			return false;
+		}
+	}
+	return options.frameTime > 0.0 && options.rate > 0.0;
+}
+
+// FNV-1a over the simulated state so runs can be compared for regressions
+uint64_t checksum(const World& world) {
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* data, size_t size) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+
+	const Population& population = world.getPopulation();
+	for (size_t i = 0; i < population.size(); ++i) {
+		mix(&population.positionX[i], sizeof(float));
+		mix(&population.positionY[i], sizeof(float));
+		mix(&population.state[i], sizeof(uint8_t));
+		uint8_t frameIndex = (uint8_t)world.getFrameIndex(i);
+		mix(&frameIndex, sizeof(uint8_t));
+		mix(&population.flipped[i], sizeof(uint8_t));
+	}
+	return hash;
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 1;
+	}
+
+	WorldSettings settings;
+	settings.seed = options.seed;
+	settings.timestep = 1.0 / options.rate;
+	settings.social.enabled = options.social;
+	// everything a tick keeps is sized for the pets up front, like the app does
+	settings.capacity = (uint32_t)options.pets;
+	if (!options.behavior.empty() && !settings.behavior.load(options.behavior)) {
+		return 1;
+	}
+	World world(settings);
+	JobSystem jobs(options.threads);
+	if (jobs.getThreadCount() > 1) {
+		world.setJobSystem(&jobs);
+	}
+	for (size_t i = 0; i < options.pets; ++i) {
+		world.spawn(glm::vec2(world.randomFloat(settings.minX, settings.maxX), 0.0f), glm::vec2(0.5f, 0.5f));
+	}
+
+	// only builds with the operator new hook count allocations, see core/Allocations.h
+	if (options.checkAllocations && !Allocations::isTracking()) {
+		std::cout << "error checking allocations | --check-allocations | Build with ALLOCATION_TRACKING to count them." << std::endl;
+		return 1;
+	}
+	// the world is sized for its pets up front, so no step may allocate, not even the first
+	auto step = [&](double dt) {
+		if (options.checkAllocations) {
+			NoAllocationScope scope(true);
+			world.step(dt);
+		}
+		else {
+			world.step(dt);
+		}
+	};
+
+	uint64_t frames = (uint64_t)(options.seconds / options.frameTime);
+	uint64_t wakeups = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	if (options.scheduled) {
+		// jumps from one pet event to the next, each jump is a wake up the app would do
+		FrameScheduler scheduler;
+		while (world.getTime() < options.seconds) {
+			step(scheduler.getWaitTime(world));
+			++wakeups;
+		}
+	}
+	else {
+		for (uint64_t i = 0; i < frames; ++i) {
+			step(options.frameTime);
+		}
+		wakeups = frames;
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double elapsed = std::chrono::duration<double>(end - start).count();
+	uint64_t ticks = world.getTickCount();
+
+	int hitchSteps = 0;
+	double hitchSeconds = 0.0;
+	if (options.hitch > 0.0) {
+		auto hitchStart = std::chrono::steady_clock::now();
+		hitchSteps = world.step(options.hitch);
+		hitchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hitchStart).count();
+	}
+	double petSteps = (double)ticks * (double)world.size();
+
+	std::cout << "pets:           " << world.size() << std::endl;
+	std::cout << "threads:        " << jobs.getThreadCount() << std::endl;
+	std::cout << "ticks:          " << ticks << std::endl;
+	std::cout << "simulated:      " << world.getTime() << " s" << std::endl;
+	std::cout << "wall time:      " << elapsed << " s" << std::endl;
+	std::cout << "pet-steps/sec:  " << (elapsed > 0.0 ? petSteps / elapsed : 0.0) << std::endl;
+	std::cout << "ms/tick:        " << (ticks ? elapsed * 1e3 / ticks : 0.0) << std::endl;
+	std::cout << "ms/sim second:  " << (world.getTime() > 0.0 ? elapsed * 1e3 / world.getTime() : 0.0) << std::endl;
+	if (options.hitch > 0.0) {
+		// pets only ever walk to targets inside the range, anything outside it overshot
+		size_t outside = 0;
+		const Population& population = world.getPopulation();
+		for (size_t i = 0; i < population.size(); ++i) {
+			outside += population.positionX[i] < settings.minX || population.positionX[i] > settings.maxX;
+		}
+		std::cout << "hitch:          " << options.hitch << " s caught up in " << hitchSteps << " steps, "
+			<< hitchSeconds * 1e3 << " ms, " << outside << " pets out of range" << std::endl;
+	}
+	std::cout << "wakeups/sec:    " << (world.getTime() > 0.0 ? wakeups / world.getTime() : 0.0) << std::endl;
+	std::cout << "kernels:        " << getKernelInstructionSet() << std::endl;
+	std::cout << "checksum:       " << std::hex << checksum(world) << std::dec << std::endl;
+	if (options.checkAllocations) {
+		std::cout << "allocations:    none while stepping" << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,127 @@
+// packs the sprite sheets into one atlas with identical frames stored once, run at build time
+// usage: atlas_baker <output.atlas> <sheet.png>:<frames> ...
+
+// render
+#include "render/Atlas.h"
+
+// stb
+#include <stb_image.h>
+
+// std
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Frame {
+	int width, height;
+	std::vector<unsigned char> pixels; // RGBA rows, bottom row first
+};
+
+// cuts a sheet into equally wide frames laid out left to right
+bool sliceSheet(const std::string& filename, int numberOfFrames, std::vector<Frame>& frames) {
+	stbi_set_flip_vertically_on_load(true); // same orientation as the textures used to be loaded with
+	int width, height, nrChannels;
+	unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrChannels, 4);
+	if (!data) {
+		std::cout << "Failed to load image | " << filename << std::endl;
+		return false;
+	}
+	if (numberOfFrames <= 0 || width % numberOfFrames != 0) {
+		std::cout << filename << " is " << width << " pixels wide, can't split it into " << numberOfFrames << " frames" << std::endl;
+		stbi_image_free(data);
+		return false;
+	}
+
+	int frameWidth = width / numberOfFrames;
+	for (int i = 0; i < numberOfFrames; ++i) {
+		Frame frame;
+		frame.width = frameWidth;
+		frame.height = height;
+		frame.pixels.resize((size_t)frameWidth * height * 4);
+		for (int y = 0; y < height; ++y) {
+			std::memcpy(&frame.pixels[(size_t)y * frameWidth * 4], &data[((size_t)y * width + (size_t)i * frameWidth) * 4], (size_t)frameWidth * 4);
+		}
+		frames.push_back(frame);
+	}
+
+	stbi_image_free(data);
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::cout << "usage: atlas_baker <output.atlas> <sheet.png>:<frames> ..." << std::endl;
+		return 1;
+	}
+
+	Atlas atlas;
+	std::vector<Frame> unique;
+	size_t totalFrames = 0;
+
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		size_t colon = arg.rfind(':');
+		if (colon == std::string::npos) {
+			std::cout << "missing frame count in " << arg << std::endl;
+			return 1;
+		}
+
+		std::vector<Frame> frames;
+		if (!sliceSheet(arg.substr(0, colon), std::atoi(arg.c_str() + colon + 1), frames)) {
+			return 1;
+		}
+
+		atlas.sheetFrameCounts.push_back((uint32_t)frames.size());
+		for (Frame& frame : frames) {
+			// a handful of frames, a linear search is plenty
+			uint32_t rectIndex = 0;
+			while (rectIndex < unique.size() && unique[rectIndex].pixels != frame.pixels) {
+				++rectIndex;
+			}
+			if (rectIndex == unique.size()) {
+				unique.push_back(frame);
+			}
+			atlas.frameRects.push_back(rectIndex);
+			++totalFrames;
+		}
+	}
+
+	// all frames are the same size, so a near square grid packs them without waste
+	int frameWidth = unique[0].width;
+	int frameHeight = unique[0].height;
+	for (const Frame& frame : unique) {
+		if (frame.width != frameWidth || frame.height != frameHeight) {
+			std::cout << "all frames need to be " << frameWidth << "x" << frameHeight << std::endl;
+			return 1;
+		}
+	}
+
+	int columns = (int)std::ceil(std::sqrt((double)unique.size()));
+	int rows = (int)((unique.size() + columns - 1) / columns);
+	atlas.width = (uint32_t)(columns * frameWidth);
+	atlas.height = (uint32_t)(rows * frameHeight);
+	atlas.pixels.assign((size_t)atlas.width * atlas.height * 4, 0);
+
+	for (size_t i = 0; i < unique.size(); ++i) {
+		AtlasRect rect;
+		rect.x = (uint16_t)((i % columns) * frameWidth);
+		rect.y = (uint16_t)((i / columns) * frameHeight);
+		rect.width = (uint16_t)frameWidth;
+		rect.height = (uint16_t)frameHeight;
+		atlas.rects.push_back(rect);
+
+		for (int y = 0; y < frameHeight; ++y) {
+			std::memcpy(&atlas.pixels[(((size_t)rect.y + y) * atlas.width + rect.x) * 4], &unique[i].pixels[(size_t)y * frameWidth * 4], (size_t)frameWidth * 4);
+		}
+	}
+
+	if (!atlas.save(argv[1])) {
+		return 1;
+	}
+
+	std::cout << "atlas: " << totalFrames << " frames, " << unique.size() << " unique, " << atlas.width << "x" << atlas.height << std::endl;
+	return 0;
+}